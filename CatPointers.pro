@@ -6,7 +6,21 @@ CONFIG += c++17
 
 HEADERS += \
     src/cat_owningPtr.h \
+	src/cat_atomicSharedPtr.h \
+	src/cat_biasedCounting.h \
+	src/cat_cowPtr.h \
+	src/cat_deferredDisposal.h \
+	src/cat_destroyTree.h \
+	src/cat_intrusivePtr.h \
+	src/cat_kindCast.h \
+	src/cat_offsetPtr.h \
+	src/cat_persistent.h \
+	src/cat_sharedMemory.h \
 	src/cat_sharedPtr.h \
+	src/cat_sharedPtrArray.h \
+	src/cat_slabPool.h \
+	src/cat_valuePtr.h \
+	src/cat_vector.h \
 	src/cat_weakPtr.h
 
 INCLUDEPATH += $$PWD/src
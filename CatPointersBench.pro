@@ -0,0 +1,29 @@
+CONFIG -= qt
+
+CONFIG += c++17
+CONFIG += console release warn_on
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += \
+	bench/autoBench.cpp \
+	bench/atomicSharedPtrBench.cpp \
+	bench/biasedCountingBench.cpp \
+	bench/controlBlockLayoutBench.cpp \
+	bench/cowPtrBench.cpp \
+	bench/deferredDisposalBench.cpp \
+	bench/destroyTreeBench.cpp \
+	bench/kindCastBench.cpp \
+	bench/persistentBench.cpp \
+	bench/offsetPtrBench.cpp \
+	bench/pointerBench.cpp \
+	bench/sharedPtrArrayBench.cpp \
+	bench/slabPoolBench.cpp \
+	bench/valuePtrBench.cpp \
+	bench/vectorBench.cpp
+
+HEADERS += \
+	bench/autoBench.h
+
+INCLUDEPATH += $$PWD/src
@@ -0,0 +1,12 @@
+CONFIG -= qt
+
+TEMPLATE = aux
+
+# make check: compiles test/codegen/pointerCodegen.cpp to assembly and checks,
+# that WeakPtr and OwningPtr compile to the same code as T* and std::unique_ptr.
+check.commands = sh $$PWD/test/codegen/checkCodegen.sh $$QMAKE_CXX
+QMAKE_EXTRA_TARGETS += check
+
+DISTFILES += \
+	test/codegen/checkCodegen.sh \
+	test/codegen/pointerCodegen.cpp
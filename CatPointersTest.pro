@@ -11,9 +11,25 @@ SOURCES += \
 	test/weakPtrTest.cpp \
 	test/owningPtrTest.cpp \
 	test/sharedPtrTest.cpp \
+	test/sharedPtrArrayTest.cpp \
+	test/intrusivePtrTest.cpp \
+	test/atomicSharedPtrTest.cpp \
+	test/biasedCountingTest.cpp \
+	test/cowPtrTest.cpp \
+	test/deferredDisposalTest.cpp \
+	test/destroyTreeTest.cpp \
+	test/kindCastTest.cpp \
+	test/offsetPtrTest.cpp \
+	test/persistentTest.cpp \
+	test/sharedMemoryTest.cpp \
+	test/slabPoolTest.cpp \
+	test/valuePtrTest.cpp \
+	test/vectorTest.cpp \
 	test/autoTest.cpp
 
 HEADERS += \
 	test/autoTest.h
 
 INCLUDEPATH += $$PWD/src
+
+unix:!macx: LIBS += -lrt
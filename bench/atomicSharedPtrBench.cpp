@@ -0,0 +1,107 @@
+#include "autoBench.h"
+
+#include "cat_atomicSharedPtr.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t LOADS_PER_THREAD = 100000;
+
+struct Table {
+	int entries[16];
+	Table(int v): entries{v} {}
+};
+
+/**
+ * Slots under test. Each one is read by all reader threads while a writer
+ * publishes a new table once in a while.
+ */
+struct AtomicSlot {
+	static constexpr const char* name = "cat::AtomicSharedPtr";
+	AtomicSharedPtr<const Table> slot{ConcurrentSharedPtr<const Table>{{}, 0}};
+
+	ConcurrentSharedPtr<const Table> load() const { return slot.load(); }
+	void store(int v) { slot.store(ConcurrentSharedPtr<const Table>{{}, v}); }
+};
+
+struct MutexSlot {
+	static constexpr const char* name = "std::mutex + cat::ConcurrentSharedPtr";
+	mutable std::mutex mutex;
+	ConcurrentSharedPtr<const Table> slot{{}, 0};
+
+	ConcurrentSharedPtr<const Table> load() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return slot;
+	}
+	void store(int v) {
+		ConcurrentSharedPtr<const Table> table{{}, v};
+		std::lock_guard<std::mutex> lock(mutex);
+		slot.swap(table);
+	}
+};
+
+struct StdAtomicSlot {
+	static constexpr const char* name = "std::atomic_load(std::shared_ptr)";
+	std::shared_ptr<const Table> slot = std::make_shared<const Table>(0);
+
+	std::shared_ptr<const Table> load() const { return std::atomic_load(&slot); }
+	void store(int v) { std::atomic_store(&slot, std::make_shared<const Table>(v)); }
+};
+
+
+template <class Slot_>
+void measureReaders(Context& ctx, size_t readerCnt) {
+	Slot_ slot;
+	const std::string subject = std::string(Slot_::name) + " (" + std::to_string(readerCnt) + " readers)";
+	ctx.measure("reader_scaling", subject, LOADS_PER_THREAD * readerCnt, [&]() {
+		std::atomic<bool> done = false;
+		std::thread writer([&]() {
+			for (int v = 1; not done.load(std::memory_order_relaxed); ++v) {
+				slot.store(v);
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+		});
+		std::vector<std::thread> readers;
+		for (size_t t = 0; t < readerCnt; ++t) {
+			readers.emplace_back([&]() {
+				for (size_t i = 0; i < LOADS_PER_THREAD; ++i) {
+					auto table = slot.load();
+					doNotOptimize(table->entries[0]);
+				}
+			});
+		}
+		for (auto& reader : readers) {
+			reader.join();
+		}
+		done = true;
+		writer.join();
+	});
+}
+
+}
+
+
+/**
+ * ns_per_op is the wall time divided by the loads of all readers. So it
+ * stays constant, if reading scales perfectly with the number of threads.
+ */
+void bench_readerScaling(Context& ctx) {
+	const size_t maxReaderCnt = std::max(2u, std::thread::hardware_concurrency());
+	for (size_t readerCnt = 1; readerCnt <= maxReaderCnt; readerCnt *= 2) {
+		measureReaders<AtomicSlot>(ctx, readerCnt);
+		measureReaders<MutexSlot>(ctx, readerCnt);
+		measureReaders<StdAtomicSlot>(ctx, readerCnt);
+	}
+}
+CAT_DECLARE_BENCHMARK(bench_readerScaling);
@@ -0,0 +1,88 @@
+#include "autoBench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+namespace cat::autoBench
+{
+
+static std::atomic<size_t> allocationCnt{0};
+
+size_t getAllocationCnt() noexcept {
+	return allocationCnt.load(std::memory_order_relaxed);
+}
+
+std::vector<BenchmarkBase*>& getAllBenchmarks() {
+	static std::vector<BenchmarkBase*> allBenchmarks;
+	return allBenchmarks;
+}
+
+void addBenchmark(BenchmarkBase* benchmark) {
+	getAllBenchmarks().push_back(benchmark);
+}
+
+void Context::_reportTiming(const std::string& benchmark, const std::string& subject, size_t ops, double nsPerOp, double allocsPerOp) {
+	std::cout << "{\"kind\": \"timing\", \"benchmark\": \"" << benchmark
+			  << "\", \"subject\": \"" << subject
+			  << "\", \"ns_per_op\": " << nsPerOp
+			  << ", \"allocs_per_op\": " << allocsPerOp
+			  << ", \"ops\": " << ops
+			  << "}" << std::endl;
+}
+
+void Context::_reportSizeof(const std::string& subject, size_t bytes) {
+	std::cout << "{\"kind\": \"sizeof\", \"subject\": \"" << subject
+			  << "\", \"bytes\": " << bytes
+			  << "}" << std::endl;
+}
+
+/**
+ * usage: CatPointersBench [filter] [repetitions]
+ * Only benchmarks whose name contains filter are run.
+ */
+int run(int argc, char *argv[]) {
+	const char* filter = argc > 1 ? argv[1] : "";
+	const size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+	Context context{repetitions};
+	for (BenchmarkBase* benchmark: getAllBenchmarks()) {
+		if (benchmark->getName().find(filter) != std::string::npos) {
+			benchmark->run(context);
+		}
+	}
+	return 0;
+}
+
+}
+
+void* operator new(std::size_t size) {
+	cat::autoBench::allocationCnt.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	cat::autoBench::allocationCnt.fetch_add(1, std::memory_order_relaxed);
+	const size_t align = static_cast<size_t>(alignment);
+	const size_t paddedSize = ((size ? size : 1) + align - 1) / align * align;
+	if (void* ptr = std::aligned_alloc(align, paddedSize)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+int main(int argc, char *argv[])
+{
+	return cat::autoBench::run(argc, argv);
+}
@@ -0,0 +1,122 @@
+#ifndef AUTOBENCH_H
+#define AUTOBENCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace cat::autoBench
+{
+
+/**
+ * Number of heap allocations made by the whole process so far. The global
+ * operator new is replaced in autoBench.cpp to keep track of it.
+ */
+size_t getAllocationCnt() noexcept;
+
+/**
+ * Keeps the compiler from optimizing a value away.
+ */
+template <class T_>
+inline void doNotOptimize(T_&& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+/**
+ * Context is handed to every benchmark function. All results are written as
+ * one JSON object per line to stdout, so they can be collected by scripts:
+ *   {"kind": "timing", "benchmark": "copy", "subject": "cat::SharedPtr", "ns_per_op": 1.9, "allocs_per_op": 0, "ops": 4096}
+ *   {"kind": "sizeof", "subject": "cat::SharedPtr<T>", "bytes": 16}
+ */
+class Context {
+	size_t _repetitions;
+
+public:
+	explicit Context(size_t repetitions): _repetitions(repetitions) {}
+
+	/**
+	 *  @brief  Runs setup() untimed and fn() timed for every repetition. fn()
+	 *  is expected to perform ops operations. The fastest repetition is reported,
+	 *  together with its allocation count.
+	 */
+	template <class Setup_, class Fn_>
+	void measure(const std::string& benchmark, const std::string& subject, size_t ops, Setup_&& setup, Fn_&& fn) {
+		double bestNs = -1;
+		size_t allocs = 0;
+		for (size_t rep = 0; rep < _repetitions + 1; ++rep) {
+			setup();
+			const size_t allocsBefore = getAllocationCnt();
+			const auto start = std::chrono::steady_clock::now();
+			fn();
+			const auto end = std::chrono::steady_clock::now();
+			const size_t allocsAfter = getAllocationCnt();
+			if (rep == 0) {
+				continue; // warm up
+			}
+			const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+			if (bestNs < 0 || ns < bestNs) {
+				bestNs = ns;
+				allocs = allocsAfter - allocsBefore;
+			}
+		}
+		_reportTiming(benchmark, subject, ops, bestNs / ops, double(allocs) / ops);
+	}
+
+	template <class Fn_>
+	void measure(const std::string& benchmark, const std::string& subject, size_t ops, Fn_&& fn) {
+		measure(benchmark, subject, ops, []() {}, std::forward<Fn_>(fn));
+	}
+
+	template <class T_>
+	void reportSizeof(const std::string& subject) {
+		_reportSizeof(subject, sizeof(T_));
+	}
+
+private:
+	void _reportTiming(const std::string& benchmark, const std::string& subject, size_t ops, double nsPerOp, double allocsPerOp);
+	void _reportSizeof(const std::string& subject, size_t bytes);
+};
+
+
+class BenchmarkBase {
+public:
+	virtual ~BenchmarkBase() {}
+
+	virtual std::string getName() = 0;
+	virtual void run(Context& context) = 0;
+};
+
+void addBenchmark(BenchmarkBase*);
+
+int run(int argc, char *argv[]);
+
+
+class Benchmark final : public BenchmarkBase {
+
+	std::string _name;
+	std::function<void(Context&)> _fn;
+public:
+	Benchmark(const std::string& name, std::function<void(Context&)> fn)
+		: _name(name),
+		  _fn(std::move(fn))
+	{
+		addBenchmark(this);
+	}
+
+	virtual std::string getName() override { return _name; }
+
+	virtual void run(Context& context) override { _fn(context); }
+};
+
+#define CAT_DECLARE_BENCHMARK(benchFn) static cat::autoBench::Benchmark b_##benchFn(#benchFn, &benchFn)
+
+}
+
+
+#endif // AUTOBENCH_H
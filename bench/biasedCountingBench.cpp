@@ -0,0 +1,116 @@
+#include "autoBench.h"
+
+#include "cat_sharedPtr.h"
+#include "cat_biasedCounting.h"
+
+#include <thread>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t BATCH_SIZE = 4096;
+constexpr int THREAD_CNT = 4;
+
+struct Payload {
+	int values[4];
+	Payload(int v): values{v, v, v, v} {}
+};
+
+template <class Counting_>
+struct CountingName;
+
+template <>
+struct CountingName<UnsyncedCounting> { static constexpr const char* name = "cat::UnsyncedCounting"; };
+
+template <>
+struct CountingName<AtomicCounting> { static constexpr const char* name = "cat::AtomicCounting"; };
+
+template <>
+struct CountingName<BiasedCounting> { static constexpr const char* name = "cat::BiasedCounting"; };
+
+
+template <class Counting_>
+void measureOwnerCopy(Context& ctx) {
+	using Ptr = SharedPtr<Payload, Counting_>;
+	Ptr src{{}, 1};
+	std::vector<Ptr> dst;
+	ctx.measure("owner_copy", CountingName<Counting_>::name, BATCH_SIZE,
+		[&]() {
+			dst.clear();
+			dst.resize(BATCH_SIZE, Ptr{nullptr});
+		},
+		[&]() {
+			for (auto& ptr : dst) {
+				ptr = src;
+			}
+			doNotOptimize(dst.data());
+		}
+	);
+}
+
+template <class Counting_>
+void measureOwnerChurn(Context& ctx) {
+	using Ptr = SharedPtr<Payload, Counting_>;
+	ctx.measure("owner_churn", CountingName<Counting_>::name, BATCH_SIZE, [&]() {
+		for (size_t i = 0; i < BATCH_SIZE; ++i) {
+			Ptr ptr{{}, int(i)};
+			Ptr copy = ptr;
+			doNotOptimize(copy.___getPtr());
+		}
+	});
+}
+
+/**
+ * The owner keeps copying its objects, while THREAD_CNT other threads copy
+ * and release them as well.
+ */
+template <class Counting_>
+void measureShared(Context& ctx) {
+	using Ptr = SharedPtr<Payload, Counting_>;
+	std::vector<Ptr> objects;
+	for (size_t i = 0; i < 64; ++i) {
+		objects.emplace_back(InplaceConstructorTag{}, int(i));
+	}
+	ctx.measure("shared_copy", CountingName<Counting_>::name, BATCH_SIZE * (THREAD_CNT + 1), [&]() {
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREAD_CNT; ++t) {
+			threads.emplace_back([&objects]() {
+				for (size_t i = 0; i < BATCH_SIZE; ++i) {
+					Ptr copy = objects[i % objects.size()];
+					doNotOptimize(copy.___getPtr());
+				}
+			});
+		}
+		for (size_t i = 0; i < BATCH_SIZE; ++i) {
+			Ptr copy = objects[i % objects.size()];
+			doNotOptimize(copy.___getPtr());
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	});
+}
+
+}
+
+
+void bench_biasedCounting(Context& ctx) {
+	ctx.reportSizeof<_sharedPtr_internal::SharedPtrRefCntInplace_<Payload, UnsyncedCounting>>("cat::SharedPtr<T> control block");
+	ctx.reportSizeof<_sharedPtr_internal::SharedPtrRefCntInplace_<Payload, BiasedCounting>>("cat::BiasedSharedPtr<T> control block");
+
+	measureOwnerCopy<UnsyncedCounting>(ctx);
+	measureOwnerCopy<AtomicCounting>(ctx);
+	measureOwnerCopy<BiasedCounting>(ctx);
+
+	measureOwnerChurn<UnsyncedCounting>(ctx);
+	measureOwnerChurn<AtomicCounting>(ctx);
+	measureOwnerChurn<BiasedCounting>(ctx);
+
+	// UnsyncedCounting is not thread-safe, so it can't take part here.
+	measureShared<AtomicCounting>(ctx);
+	measureShared<BiasedCounting>(ctx);
+}
+CAT_DECLARE_BENCHMARK(bench_biasedCounting);
@@ -0,0 +1,82 @@
+#include "autoBench.h"
+
+#include "cat_sharedPtr.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t READS_PER_THREAD = 1000000;
+
+struct Config {
+	int values[8];
+	Config(int v): values{v, v, v, v, v, v, v, v} {}
+};
+
+struct IsolatedConfig: Config {
+	using Config::Config;
+};
+CAT_ISOLATED_USAGE_CNT(IsolatedConfig)
+
+/**
+ * Half of the threads read the payload, the other half keep copying the
+ * pointer (and so modify the usage count) until the readers are done.
+ */
+template <class T_>
+void measureContention(Context& ctx, const char* subject, size_t threadCnt) {
+	ConcurrentSharedPtr<const T_> shared{{}, 1};
+	const size_t readerCnt = std::max<size_t>(1, threadCnt / 2);
+	const size_t copierCnt = std::max<size_t>(1, threadCnt - readerCnt);
+	const std::string fullSubject = std::string(subject) + " (" + std::to_string(readerCnt) + " readers, " + std::to_string(copierCnt) + " copiers)";
+	ctx.measure("read_while_copying", fullSubject, READS_PER_THREAD * readerCnt, [&]() {
+		std::atomic<bool> done = false;
+		std::vector<std::thread> copiers;
+		for (size_t t = 0; t < copierCnt; ++t) {
+			copiers.emplace_back([&]() {
+				while (not done.load(std::memory_order_relaxed)) {
+					ConcurrentSharedPtr<const T_> copy = shared;
+					doNotOptimize(copy.___getPtr());
+				}
+			});
+		}
+		std::vector<std::thread> readers;
+		for (size_t t = 0; t < readerCnt; ++t) {
+			readers.emplace_back([&]() {
+				const T_* config = shared.___getPtr();
+				int sum = 0;
+				for (size_t i = 0; i < READS_PER_THREAD; ++i) {
+					doNotOptimize(config);
+					sum += config->values[i % 8];
+				}
+				doNotOptimize(sum);
+			});
+		}
+		for (auto& reader : readers) {
+			reader.join();
+		}
+		done = true;
+		for (auto& copier : copiers) {
+			copier.join();
+		}
+	});
+}
+
+}
+
+
+void bench_controlBlockLayout(Context& ctx) {
+	ctx.reportSizeof<_sharedPtr_internal::SharedPtrRefCntInplace_<Config, AtomicCounting>>("control block of cat::ConcurrentSharedPtr<T>");
+	ctx.reportSizeof<_sharedPtr_internal::SharedPtrRefCntInplace_<IsolatedConfig, AtomicCounting>>("control block of cat::ConcurrentSharedPtr<T> (isolated usage count)");
+
+	const size_t threadCnt = std::max(2u, std::thread::hardware_concurrency());
+	measureContention<Config>(ctx, "cat::ConcurrentSharedPtr", threadCnt);
+	measureContention<IsolatedConfig>(ctx, "cat::ConcurrentSharedPtr (isolated usage count)", threadCnt);
+}
+CAT_DECLARE_BENCHMARK(bench_controlBlockLayout);
@@ -0,0 +1,60 @@
+#include "autoBench.h"
+
+#include "cat_cowPtr.h"
+
+#include <string>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t LINE_CNT = 1000;
+constexpr size_t STAGE_CNT = 16;
+constexpr size_t WRITING_STAGE = 8; // only one stage modifies the document.
+
+struct Document {
+	std::vector<std::string> lines;
+};
+
+Document makeDocument() {
+	Document doc;
+	for (size_t i = 0; i < LINE_CNT; ++i) {
+		doc.lines.push_back("line number " + std::to_string(i) + " of a rather large document");
+	}
+	return doc;
+}
+
+}
+
+
+void bench_cowPtr(Context& ctx) {
+	const Document original = makeDocument();
+
+	ctx.measure("pipeline", "Document (deep copies)", STAGE_CNT, [&]() {
+		Document doc = original;
+		for (size_t stage = 0; stage < STAGE_CNT; ++stage) {
+			Document next = doc;
+			if (stage == WRITING_STAGE) {
+				next.lines[0] = "changed";
+			}
+			doNotOptimize(next.lines.size());
+			doc = std::move(next);
+		}
+	});
+
+	const CowPtr<Document> cowOriginal{{}, original};
+	ctx.measure("pipeline", "cat::CowPtr", STAGE_CNT, [&]() {
+		CowPtr<Document> doc = cowOriginal;
+		for (size_t stage = 0; stage < STAGE_CNT; ++stage) {
+			CowPtr<Document> next = doc;
+			if (stage == WRITING_STAGE) {
+				next.getMutable().lines[0] = "changed";
+			}
+			doNotOptimize(next->lines.size());
+			doc = std::move(next);
+		}
+	});
+}
+CAT_DECLARE_BENCHMARK(bench_cowPtr);
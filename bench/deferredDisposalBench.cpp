@@ -0,0 +1,78 @@
+#include "autoBench.h"
+
+#include "cat_sharedPtr.h"
+
+#include <string>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t NODE_CNT = 10000;
+
+template <bool IsDeferred_>
+struct Node {
+	SharedPtr<Node> next;
+	int value;
+
+	Node(SharedPtr<Node> next, int value): next(std::move(next)), value(value) {}
+};
+
+}
+
+namespace cat {
+template <>
+struct UseDeferredDisposal<Node<true>>: std::true_type {};
+}
+
+namespace {
+
+template <bool IsDeferred_>
+SharedPtr<Node<IsDeferred_>> makeList() {
+	SharedPtr<Node<IsDeferred_>> head{nullptr};
+	for (size_t i = 0; i < NODE_CNT; ++i) {
+		head = SharedPtr<Node<IsDeferred_>>{{}, std::move(head), int(i)};
+	}
+	return head;
+}
+
+/**
+ * Measures, how long the thread that releases the last reference to a list
+ * of NODE_CNT nodes is blocked.
+ */
+template <bool IsDeferred_>
+void measureRelease(Context& ctx) {
+	const std::string subject = IsDeferred_ ? "deferred" : "synchronous";
+	SharedPtr<Node<IsDeferred_>> head{nullptr};
+	ctx.measure("release_list", subject, 1,
+		[&]() {
+			reclaim();
+			head = makeList<IsDeferred_>();
+		},
+		[&]() {
+			head = nullptr;
+		}
+	);
+	reclaim();
+}
+
+}
+
+
+void bench_deferredDisposal(Context& ctx) {
+	measureRelease<false>(ctx);
+	measureRelease<true>(ctx);
+
+	SharedPtr<Node<true>> head{nullptr};
+	ctx.measure("reclaim_list", "deferred", NODE_CNT,
+		[&]() {
+			head = makeList<true>();
+			head = nullptr;
+		},
+		[&]() {
+			doNotOptimize(reclaim());
+		}
+	);
+}
+CAT_DECLARE_BENCHMARK(bench_deferredDisposal);
@@ -0,0 +1,68 @@
+#include "autoBench.h"
+
+#include "cat_destroyTree.h"
+
+#include <thread>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr int DEPTH = 7;
+constexpr int WIDTH = 8;
+
+struct Node {
+	std::vector<OwningPtr<Node>> children;
+	int value;
+
+	Node(int value): value(value) {}
+
+	template <class Fn_>
+	void detachChildren(Fn_&& fn) {
+		for (auto& child : children) {
+			fn(std::move(child));
+		}
+	}
+};
+
+OwningPtr<Node> makeTree(int depth) {
+	OwningPtr<Node> node{{}, depth};
+	if (depth > 1) {
+		node->children.reserve(WIDTH);
+		for (int i = 0; i < WIDTH; ++i) {
+			node->children.push_back(makeTree(depth - 1));
+		}
+	}
+	return node;
+}
+
+constexpr size_t nodeCnt() {
+	size_t cnt = 0;
+	size_t levelCnt = 1;
+	for (int d = 0; d < DEPTH; ++d) {
+		cnt += levelCnt;
+		levelCnt *= WIDTH;
+	}
+	return cnt;
+}
+
+template <class Fn_>
+void measureTeardown(Context& ctx, const char* subject, Fn_&& destroy) {
+	OwningPtr<Node> root;
+	ctx.measure("destroy_tree", subject, nodeCnt(),
+		[&]() { root = makeTree(DEPTH); },
+		[&]() { destroy(std::move(root)); }
+	);
+}
+
+}
+
+
+void bench_destroyTree(Context& ctx) {
+	measureTeardown(ctx, "~OwningPtr (recursive)", [](OwningPtr<Node>&& root) { root = nullptr; });
+	measureTeardown(ctx, "cat::destroyTree", [](OwningPtr<Node>&& root) { destroyTree(std::move(root)); });
+	measureTeardown(ctx, "cat::destroyTreeParallel", [](OwningPtr<Node>&& root) { destroyTreeParallel(std::move(root)); });
+}
+CAT_DECLARE_BENCHMARK(bench_destroyTree);
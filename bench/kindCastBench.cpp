@@ -0,0 +1,111 @@
+#include "autoBench.h"
+
+#include "catPointers.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t BATCH_SIZE = 4096;
+constexpr int DEPTH = 8;
+constexpr int WIDTH = 32;
+
+/**
+ * A chain of DEPTH subclasses. Deep<N, true> declares the kinds [N, DEPTH].
+ */
+template <int N_, bool HasKind_>
+struct Deep: Deep<N_ - 1, HasKind_> {
+	Deep(): Deep<N_ - 1, HasKind_>(N_) {}
+protected:
+	Deep(Kind kind): Deep<N_ - 1, HasKind_>(kind) {}
+};
+
+template <bool HasKind_>
+struct Deep<0, HasKind_> {
+	const Kind kind;
+	Deep(Kind kind = 0): kind(kind) {}
+	virtual ~Deep() {}
+	Kind getKind() const { return kind; }
+};
+
+template <int N_>
+constexpr KindRange ___catKindRange(KindTag<Deep<N_, true>>) noexcept { return {N_, DEPTH}; }
+
+
+/**
+ * WIDTH subclasses of the same base. Wide<N, true> declares the kind N.
+ */
+template <bool HasKind_>
+struct WideBase {
+	const Kind kind;
+	WideBase(Kind kind): kind(kind) {}
+	virtual ~WideBase() {}
+	Kind getKind() const { return kind; }
+};
+
+template <int N_, bool HasKind_>
+struct Wide: WideBase<HasKind_> {
+	Wide(): WideBase<HasKind_>(N_) {}
+};
+
+constexpr KindRange ___catKindRange(KindTag<WideBase<true>>) noexcept { return {0, WIDTH}; }
+
+template <int N_>
+constexpr KindRange ___catKindRange(KindTag<Wide<N_, true>>) noexcept { return {N_, N_}; }
+
+
+template <bool HasKind_, int... Ns_>
+std::vector<std::unique_ptr<WideBase<HasKind_>>> makeWideObjects(std::integer_sequence<int, Ns_...>) {
+	std::vector<std::unique_ptr<WideBase<HasKind_>>> objects;
+	for (size_t i = 0; i < BATCH_SIZE / WIDTH; ++i) {
+		(objects.emplace_back(new Wide<Ns_ + 1, HasKind_>()), ...);
+	}
+	return objects;
+}
+
+template <bool HasKind_>
+void measureDeep(Context& ctx, const char* subject) {
+	Deep<DEPTH, HasKind_> object;
+	WeakPtr<Deep<0, HasKind_>> base{&object};
+	doNotOptimize(base);
+	ctx.measure("deep_cast_leaf", subject, BATCH_SIZE, [&]() {
+		for (size_t i = 0; i < BATCH_SIZE; ++i) {
+			doNotOptimize(base.template as<Deep<DEPTH, HasKind_>>());
+		}
+	});
+	ctx.measure("deep_cast_middle", subject, BATCH_SIZE, [&]() {
+		for (size_t i = 0; i < BATCH_SIZE; ++i) {
+			doNotOptimize(base.template as<Deep<DEPTH / 2, HasKind_>>());
+		}
+	});
+}
+
+template <bool HasKind_>
+void measureWide(Context& ctx, const char* subject) {
+	auto objects = makeWideObjects<HasKind_>(std::make_integer_sequence<int, WIDTH>{});
+	std::vector<WeakPtr<WideBase<HasKind_>>> bases;
+	for (auto& object : objects) {
+		bases.emplace_back(object.get());
+	}
+	ctx.measure("wide_cast", subject, bases.size(), [&]() {
+		for (const auto& base : bases) {
+			doNotOptimize(base.template as<Wide<WIDTH / 2, HasKind_>>());
+		}
+	});
+}
+
+}
+
+
+void bench_kindCast(Context& ctx) {
+	measureDeep<false>(ctx, "dynamic_cast");
+	measureDeep<true>(ctx, "cat::kindCast");
+	measureWide<false>(ctx, "dynamic_cast");
+	measureWide<true>(ctx, "cat::kindCast");
+}
+CAT_DECLARE_BENCHMARK(bench_kindCast);
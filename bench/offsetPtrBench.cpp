@@ -0,0 +1,126 @@
+#include "autoBench.h"
+
+#include "catPointers.h"
+#include "cat_offsetPtr.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr int DEPTH = 6;
+constexpr int WIDTH = 8;
+
+struct Node {
+	std::vector<OwningPtr<Node>> children;
+	WeakPtr<Node> parent;
+	int value;
+
+	Node(int value): value(value) {}
+};
+
+struct OffsetNode {
+	OffsetArray<OffsetOwningPtr<OffsetNode>> children;
+	OffsetWeakPtr<OffsetNode> parent;
+	int value;
+};
+
+/**
+ * The conventional format: the nodes in pre-order, as (value, childCnt) pairs.
+ */
+void serialize(std::vector<int>& records, int depth) {
+	records.push_back(depth);
+	records.push_back(depth > 1 ? WIDTH : 0);
+	if (depth > 1) {
+		for (int i = 0; i < WIDTH; ++i) {
+			serialize(records, depth - 1);
+		}
+	}
+}
+
+OwningPtr<Node> deserialize(const int*& records, WeakPtr<Node> parent) {
+	OwningPtr<Node> node{{}, records[0]};
+	const int childCnt = records[1];
+	records += 2;
+	node->parent = parent;
+	node->children.reserve(childCnt);
+	for (int i = 0; i < childCnt; ++i) {
+		node->children.push_back(deserialize(records, node.getWeak()));
+	}
+	return node;
+}
+
+RelocatableRef<OffsetNode> write(RelocatableWriter& writer, int depth) {
+	auto node = writer.create<OffsetNode>();
+	writer.get(node)->value = depth;
+	if (depth > 1) {
+		auto children = writer.createArray<OffsetOwningPtr<OffsetNode>>(WIDTH);
+		writer.get(node)->children = {writer.get(children), WIDTH};
+		for (int i = 0; i < WIDTH; ++i) {
+			auto child = write(writer, depth - 1);
+			writer.get(child)->parent = writer.get(node);
+			writer.get(children)[i].reset(writer.get(child));
+		}
+	}
+	return node;
+}
+
+template <class Node_>
+long long sumTree(const Node_& node) {
+	long long sum = node.value;
+	for (const auto& child : node.children) {
+		sum += sumTree(*child) + child->parent->value;
+	}
+	return sum;
+}
+
+constexpr size_t nodeCnt() {
+	size_t cnt = 0;
+	size_t levelCnt = 1;
+	for (int d = 0; d < DEPTH; ++d) {
+		cnt += levelCnt;
+		levelCnt *= WIDTH;
+	}
+	return cnt;
+}
+
+}
+
+
+void bench_offsetPtr(Context& ctx) {
+	std::vector<int> records;
+	serialize(records, DEPTH);
+	RelocatableWriter writer;
+	write(writer, DEPTH);
+	const std::vector<std::byte> buffer = writer.release();
+
+	OwningPtr<Node> root;
+	ctx.measure("load_tree", "cat::OwningPtr (deserialize)", nodeCnt(),
+		[&]() { root = nullptr; },
+		[&]() {
+			const int* pos = records.data();
+			root = deserialize(pos, nullptr);
+		}
+	);
+	std::unique_ptr<std::max_align_t[]> loaded;
+	ctx.measure("load_tree", "cat::OffsetOwningPtr (copy buffer)", nodeCnt(),
+		[&]() { loaded = nullptr; },
+		[&]() {
+			loaded.reset(new std::max_align_t[buffer.size() / sizeof(std::max_align_t) + 1]);
+			std::memcpy(loaded.get(), buffer.data(), buffer.size());
+		}
+	);
+
+	ctx.measure("traverse_tree", "cat::OwningPtr", nodeCnt(), [&]() {
+		doNotOptimize(sumTree(*root));
+	});
+	const OffsetNode* offsetRoot = relocatableRoot<OffsetNode>(static_cast<const void*>(loaded.get()));
+	ctx.measure("traverse_tree", "cat::OffsetOwningPtr", nodeCnt(), [&]() {
+		doNotOptimize(sumTree(*offsetRoot));
+	});
+}
+CAT_DECLARE_BENCHMARK(bench_offsetPtr);
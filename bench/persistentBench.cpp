@@ -0,0 +1,97 @@
+#include "autoBench.h"
+
+#include "cat_persistent.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t ELEMENT_CNT = 100000;
+constexpr size_t VERSION_CNT = 100;
+
+}
+
+
+void bench_persistent(Context& ctx) {
+	// every version is a snapshot of the previous one with one change.
+	std::vector<int> vector(ELEMENT_CNT, 0);
+	ctx.measure("snapshot_and_set", "std::vector", VERSION_CNT, [&]() {
+		std::vector<std::vector<int>> versions;
+		for (size_t i = 0; i < VERSION_CNT; ++i) {
+			versions.push_back(vector);
+			vector[(i * 7919) % ELEMENT_CNT] = int(i);
+		}
+		doNotOptimize(versions.data());
+	});
+
+	PersistentVector<int> persistentVector;
+	for (size_t i = 0; i < ELEMENT_CNT; ++i) {
+		persistentVector.pushBack(0);
+	}
+	ctx.measure("snapshot_and_set", "cat::PersistentVector", VERSION_CNT, [&]() {
+		std::vector<PersistentVector<int>> versions;
+		for (size_t i = 0; i < VERSION_CNT; ++i) {
+			versions.push_back(persistentVector);
+			persistentVector.set((i * 7919) % ELEMENT_CNT, int(i));
+		}
+		doNotOptimize(versions.data());
+	});
+
+	ctx.measure("get", "std::vector", ELEMENT_CNT, [&]() {
+		long long sum = 0;
+		for (size_t i = 0; i < ELEMENT_CNT; ++i) {
+			sum += vector[i];
+		}
+		doNotOptimize(sum);
+	});
+	ctx.measure("get", "cat::PersistentVector", ELEMENT_CNT, [&]() {
+		long long sum = 0;
+		for (size_t i = 0; i < ELEMENT_CNT; ++i) {
+			sum += persistentVector[i];
+		}
+		doNotOptimize(sum);
+	});
+
+	std::unordered_map<int, int> map;
+	PersistentMap<int, int> persistentMap;
+	for (size_t i = 0; i < ELEMENT_CNT; ++i) {
+		map.emplace(int(i), 0);
+		persistentMap.set(int(i), 0);
+	}
+	ctx.measure("snapshot_and_set", "std::unordered_map", VERSION_CNT, [&]() {
+		std::vector<std::unordered_map<int, int>> versions;
+		for (size_t i = 0; i < VERSION_CNT; ++i) {
+			versions.push_back(map);
+			map[int((i * 7919) % ELEMENT_CNT)] = int(i);
+		}
+		doNotOptimize(versions.data());
+	});
+	ctx.measure("snapshot_and_set", "cat::PersistentMap", VERSION_CNT, [&]() {
+		std::vector<PersistentMap<int, int>> versions;
+		for (size_t i = 0; i < VERSION_CNT; ++i) {
+			versions.push_back(persistentMap);
+			persistentMap.set(int((i * 7919) % ELEMENT_CNT), int(i));
+		}
+		doNotOptimize(versions.data());
+	});
+
+	ctx.measure("find", "std::unordered_map", ELEMENT_CNT, [&]() {
+		long long sum = 0;
+		for (size_t i = 0; i < ELEMENT_CNT; ++i) {
+			sum += map.find(int(i))->second;
+		}
+		doNotOptimize(sum);
+	});
+	ctx.measure("find", "cat::PersistentMap", ELEMENT_CNT, [&]() {
+		long long sum = 0;
+		for (size_t i = 0; i < ELEMENT_CNT; ++i) {
+			sum += *persistentMap.find(int(i));
+		}
+		doNotOptimize(sum);
+	});
+}
+CAT_DECLARE_BENCHMARK(bench_persistent);
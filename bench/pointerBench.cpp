@@ -0,0 +1,413 @@
+#include "autoBench.h"
+
+#include "cat_weakPtr.h"
+#include "cat_owningPtr.h"
+#include "cat_sharedPtr.h"
+#include "cat_intrusivePtr.h"
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t BATCH_SIZE = 4096;
+
+struct BenchBase {
+	virtual ~BenchBase() {}
+	virtual int value() const { return 0; }
+};
+
+struct BenchDerived: BenchBase {
+	int payload[4];
+	BenchDerived(int v): payload{v, v, v, v} {}
+	virtual int value() const override { return payload[0]; }
+};
+
+struct IntrusiveBenchDerived: BenchDerived, IntrusiveRefCnt<IntrusiveBenchDerived> {
+	using BenchDerived::BenchDerived;
+};
+
+/**
+ * Factories for all pointer types under test, so that each benchmark can be
+ * written once for all of them.
+ */
+struct RawSubject {
+	using Ptr = BenchDerived*;
+	static constexpr const char* name = "T*";
+	static Ptr make(int v) { return new BenchDerived(v); }
+	static void release(Ptr& ptr) { delete ptr; ptr = nullptr; }
+};
+
+struct UniqueSubject {
+	using Ptr = std::unique_ptr<BenchDerived>;
+	static constexpr const char* name = "std::unique_ptr";
+	static Ptr make(int v) { return std::make_unique<BenchDerived>(v); }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct StdSharedSubject {
+	using Ptr = std::shared_ptr<BenchDerived>;
+	static constexpr const char* name = "std::shared_ptr";
+	static Ptr make(int v) { return std::make_shared<BenchDerived>(v); }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct OwningSubject {
+	using Ptr = OwningPtr<BenchDerived>;
+	static constexpr const char* name = "cat::OwningPtr";
+	static Ptr make(int v) { return Ptr{{}, v}; }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct SharedSubject {
+	using Ptr = SharedPtr<BenchDerived>;
+	static constexpr const char* name = "cat::SharedPtr";
+	static Ptr make(int v) { return Ptr{{}, v}; }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+/**
+ * Objects that are built with a single owner first and shared afterwards.
+ */
+struct StdSharedFromUniqueSubject {
+	using Ptr = std::shared_ptr<BenchDerived>;
+	static constexpr const char* name = "std::shared_ptr (from std::unique_ptr)";
+	static Ptr make(int v) { return Ptr(std::make_unique<BenchDerived>(v)); }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct SharedFromOwningSubject {
+	using Ptr = SharedPtr<BenchDerived>;
+	static constexpr const char* name = "cat::SharedPtr (from cat::OwningPtr)";
+	static Ptr make(int v) { return Ptr(OwningPtr<BenchDerived>{{}, v}); }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct SharedFromPromotableSubject {
+	using Ptr = SharedPtr<BenchDerived>;
+	static constexpr const char* name = "cat::SharedPtr (from cat::PromotableOwningPtr)";
+	static Ptr make(int v) { return Ptr(PromotableOwningPtr<BenchDerived>{{}, v}); }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct CompactSharedSubject {
+	using Ptr = CompactSharedPtr<BenchDerived>;
+	static constexpr const char* name = "cat::CompactSharedPtr";
+	static Ptr make(int v) { return Ptr{{}, v}; }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct ConcurrentSharedSubject {
+	using Ptr = ConcurrentSharedPtr<BenchDerived>;
+	static constexpr const char* name = "cat::ConcurrentSharedPtr";
+	static Ptr make(int v) { return Ptr{{}, v}; }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+struct IntrusiveSubject {
+	using Ptr = IntrusivePtr<IntrusiveBenchDerived>;
+	static constexpr const char* name = "cat::IntrusivePtr";
+	static Ptr make(int v) { return Ptr{{}, v}; }
+	static void release(Ptr& ptr) { ptr = nullptr; }
+};
+
+
+template <class Subject_>
+void measureConstruct(Context& ctx) {
+	std::vector<typename Subject_::Ptr> ptrs;
+	ctx.measure("construct", Subject_::name, BATCH_SIZE,
+		[&]() {
+			for (auto& ptr : ptrs) { Subject_::release(ptr); }
+			ptrs.clear();
+			ptrs.reserve(BATCH_SIZE);
+		},
+		[&]() {
+			for (size_t i = 0; i < BATCH_SIZE; ++i) {
+				ptrs.push_back(Subject_::make(int(i)));
+			}
+		}
+	);
+	for (auto& ptr : ptrs) { Subject_::release(ptr); }
+}
+
+template <class Subject_>
+void measureDestroy(Context& ctx) {
+	std::vector<typename Subject_::Ptr> ptrs;
+	ctx.measure("destroy", Subject_::name, BATCH_SIZE,
+		[&]() {
+			ptrs.reserve(BATCH_SIZE);
+			for (size_t i = 0; i < BATCH_SIZE; ++i) {
+				ptrs.push_back(Subject_::make(int(i)));
+			}
+		},
+		[&]() {
+			for (auto& ptr : ptrs) { Subject_::release(ptr); }
+			ptrs.clear();
+		}
+	);
+}
+
+template <class Ptr_>
+void measureCopy(Context& ctx, const char* subject, const Ptr_& src) {
+	std::vector<Ptr_> dst;
+	ctx.measure("copy", subject, BATCH_SIZE,
+		[&]() {
+			dst.clear();
+			dst.resize(BATCH_SIZE, Ptr_{nullptr});
+		},
+		[&]() {
+			for (auto& ptr : dst) {
+				ptr = src;
+			}
+			doNotOptimize(dst.data());
+		}
+	);
+}
+
+template <class Subject_>
+void measureMove(Context& ctx) {
+	std::vector<typename Subject_::Ptr> src;
+	std::vector<typename Subject_::Ptr> dst;
+	ctx.measure("move", Subject_::name, BATCH_SIZE,
+		[&]() {
+			for (auto& ptr : dst) { Subject_::release(ptr); }
+			dst.clear();
+			src.clear();
+			for (size_t i = 0; i < BATCH_SIZE; ++i) {
+				dst.emplace_back(nullptr);
+				src.push_back(Subject_::make(int(i)));
+			}
+		},
+		[&]() {
+			for (size_t i = 0; i < BATCH_SIZE; ++i) {
+				dst[i] = std::move(src[i]);
+			}
+			doNotOptimize(dst.data());
+		}
+	);
+	for (auto& ptr : dst) { Subject_::release(ptr); }
+}
+
+template <class Subject_>
+void measureGrowth(Context& ctx) {
+	std::vector<typename Subject_::Ptr> src;
+	std::vector<typename Subject_::Ptr> dst;
+	ctx.measure("vector_growth", Subject_::name, BATCH_SIZE,
+		[&]() {
+			for (auto& ptr : dst) { Subject_::release(ptr); }
+			std::vector<typename Subject_::Ptr>().swap(dst);
+			src.clear();
+			for (size_t i = 0; i < BATCH_SIZE; ++i) {
+				src.push_back(Subject_::make(int(i)));
+			}
+		},
+		[&]() {
+			for (auto& ptr : src) {
+				dst.push_back(std::move(ptr));
+			}
+		}
+	);
+	for (auto& ptr : dst) { Subject_::release(ptr); }
+}
+
+template <class Fn_>
+void measureCast(Context& ctx, const char* benchmark, const char* subject, Fn_&& cast) {
+	ctx.measure(benchmark, subject, BATCH_SIZE, [&]() {
+		for (size_t i = 0; i < BATCH_SIZE; ++i) {
+			doNotOptimize(cast());
+		}
+	});
+}
+
+/**
+ * A binary tree node, as in the README's TreeNode example.
+ */
+template <class Ptr_>
+struct BenchTreeNode {
+	int value;
+	Ptr_ left;
+	Ptr_ right;
+
+	BenchTreeNode(int value): value(value), left(), right() {}
+};
+
+struct HeapTreeNode: BenchTreeNode<OwningPtr<HeapTreeNode>> {
+	using BenchTreeNode::BenchTreeNode;
+};
+
+struct ArenaTreeNode: BenchTreeNode<ArenaOwningPtr<ArenaTreeNode>> {
+	using BenchTreeNode::BenchTreeNode;
+};
+
+struct SkippedArenaTreeNode: BenchTreeNode<ArenaOwningPtr<SkippedArenaTreeNode>> {
+	using BenchTreeNode::BenchTreeNode;
+};
+
+}
+
+template <>
+struct cat::SkipArenaDestruction<SkippedArenaTreeNode>: std::true_type {};
+
+namespace {
+
+template <class Ptr_, class... Arena_>
+void buildTree(Ptr_& node, int depth, Arena_&... arena) {
+	node = Ptr_{arena..., InplaceConstructorTag{}, depth};
+	if (depth > 0) {
+		buildTree(node->left, depth - 1, arena...);
+		buildTree(node->right, depth - 1, arena...);
+	}
+}
+
+template <class Node_, class... Arena_>
+void measureTree(Context& ctx, const char* subject, Arena_&... arena) {
+	constexpr int depth = 11;
+	constexpr size_t nodeCnt = (size_t(1) << (depth + 1)) - 1;
+	decltype(Node_::left) root;
+	ctx.measure("tree_build", subject, nodeCnt,
+		[&]() { root = nullptr; (arena.release(), ...); },
+		[&]() { buildTree(root, depth, arena...); }
+	);
+	ctx.measure("tree_teardown", subject, nodeCnt,
+		[&]() { root = nullptr; (arena.release(), ...); buildTree(root, depth, arena...); },
+		[&]() { root = nullptr; (arena.release(), ...); }
+	);
+}
+
+}
+
+
+void bench_sizeof(Context& ctx) {
+	ctx.reportSizeof<BenchDerived*>("T*");
+	ctx.reportSizeof<std::unique_ptr<BenchDerived>>("std::unique_ptr<T>");
+	ctx.reportSizeof<std::shared_ptr<BenchDerived>>("std::shared_ptr<T>");
+	ctx.reportSizeof<WeakPtr<BenchDerived>>("cat::WeakPtr<T>");
+	ctx.reportSizeof<OwningPtr<BenchDerived>>("cat::OwningPtr<T>");
+	ctx.reportSizeof<PromotableOwningPtr<BenchDerived>>("cat::PromotableOwningPtr<T>");
+	ctx.reportSizeof<SharedPtr<BenchDerived>>("cat::SharedPtr<T>");
+	ctx.reportSizeof<ConcurrentSharedPtr<BenchDerived>>("cat::ConcurrentSharedPtr<T>");
+	ctx.reportSizeof<CompactSharedPtr<BenchDerived>>("cat::CompactSharedPtr<T>");
+	ctx.reportSizeof<IntrusivePtr<IntrusiveBenchDerived>>("cat::IntrusivePtr<T>");
+	ctx.reportSizeof<_sharedPtr_internal::SharedPtrRefCntInplace_<BenchDerived>>("cat::SharedPtr<T> control block");
+	ctx.reportSizeof<_sharedPtr_internal::SharedPtrRefCntInplace_<BenchDerived, ObservableCounting<>>>("cat::ObservableSharedPtr<T> control block");
+	ctx.reportSizeof<ObserverPtr<BenchDerived>>("cat::ObserverPtr<T>");
+}
+CAT_DECLARE_BENCHMARK(bench_sizeof);
+
+
+void bench_construct(Context& ctx) {
+	measureConstruct<RawSubject>(ctx);
+	measureConstruct<UniqueSubject>(ctx);
+	measureConstruct<StdSharedSubject>(ctx);
+	measureConstruct<OwningSubject>(ctx);
+	measureConstruct<SharedSubject>(ctx);
+	measureConstruct<CompactSharedSubject>(ctx);
+	measureConstruct<IntrusiveSubject>(ctx);
+	measureConstruct<ConcurrentSharedSubject>(ctx);
+	measureConstruct<StdSharedFromUniqueSubject>(ctx);
+	measureConstruct<SharedFromOwningSubject>(ctx);
+	measureConstruct<SharedFromPromotableSubject>(ctx);
+}
+CAT_DECLARE_BENCHMARK(bench_construct);
+
+
+void bench_destroy(Context& ctx) {
+	measureDestroy<RawSubject>(ctx);
+	measureDestroy<UniqueSubject>(ctx);
+	measureDestroy<StdSharedSubject>(ctx);
+	measureDestroy<OwningSubject>(ctx);
+	measureDestroy<SharedSubject>(ctx);
+	measureDestroy<CompactSharedSubject>(ctx);
+	measureDestroy<IntrusiveSubject>(ctx);
+	measureDestroy<ConcurrentSharedSubject>(ctx);
+}
+CAT_DECLARE_BENCHMARK(bench_destroy);
+
+
+void bench_copy(Context& ctx) {
+	BenchDerived value{1};
+	measureCopy(ctx, "T*", &value);
+	measureCopy(ctx, "cat::WeakPtr", WeakPtr<BenchDerived>(&value));
+	measureCopy(ctx, "std::shared_ptr", std::make_shared<BenchDerived>(1));
+	measureCopy(ctx, "cat::SharedPtr", SharedPtr<BenchDerived>({}, 1));
+	measureCopy(ctx, "cat::CompactSharedPtr", CompactSharedPtr<BenchDerived>({}, 1));
+	measureCopy(ctx, "cat::IntrusivePtr", IntrusivePtr<IntrusiveBenchDerived>({}, 1));
+	measureCopy(ctx, "cat::ConcurrentSharedPtr", ConcurrentSharedPtr<BenchDerived>({}, 1));
+}
+CAT_DECLARE_BENCHMARK(bench_copy);
+
+
+void bench_move(Context& ctx) {
+	measureMove<RawSubject>(ctx);
+	measureMove<UniqueSubject>(ctx);
+	measureMove<StdSharedSubject>(ctx);
+	measureMove<OwningSubject>(ctx);
+	measureMove<SharedSubject>(ctx);
+	measureMove<CompactSharedSubject>(ctx);
+	measureMove<IntrusiveSubject>(ctx);
+	measureMove<ConcurrentSharedSubject>(ctx);
+}
+CAT_DECLARE_BENCHMARK(bench_move);
+
+
+void bench_cast(Context& ctx) {
+	BenchDerived value{1};
+	BenchBase* raw = &value;
+	WeakPtr<BenchBase> weak{&value};
+	OwningPtr<BenchBase> owning{new BenchDerived(1)};
+	std::shared_ptr<BenchBase> stdShared = std::make_shared<BenchDerived>(1);
+	SharedPtr<BenchBase> shared = SharedPtr<BenchDerived>{{}, 1};
+
+	measureCast(ctx, "dynamic_cast", "T*", [&]() { return dynamic_cast<BenchDerived*>(raw); });
+	measureCast(ctx, "dynamic_cast", "cat::WeakPtr", [&]() { return weak.as<BenchDerived>(); });
+	measureCast(ctx, "dynamic_cast", "cat::OwningPtr", [&]() { return owning.as<BenchDerived>(); });
+	measureCast(ctx, "dynamic_cast", "cat::SharedPtr", [&]() { return shared.as<BenchDerived>(); });
+
+	measureCast(ctx, "static_cast", "T*", [&]() { return static_cast<BenchDerived*>(raw); });
+	measureCast(ctx, "static_cast", "cat::WeakPtr", [&]() { return weak.asStatic<BenchDerived>(); });
+	measureCast(ctx, "static_cast", "cat::OwningPtr", [&]() { return owning.asStatic<BenchDerived>(); });
+	measureCast(ctx, "static_cast", "cat::SharedPtr", [&]() { return shared.asStatic<BenchDerived>(); });
+
+	measureCast(ctx, "shared_dynamic_cast", "std::shared_ptr", [&]() { return std::dynamic_pointer_cast<BenchDerived>(stdShared); });
+	measureCast(ctx, "shared_dynamic_cast", "cat::SharedPtr", [&]() { return shared.asShared<BenchDerived>(); });
+	measureCast(ctx, "shared_static_cast", "std::shared_ptr", [&]() { return std::static_pointer_cast<BenchDerived>(stdShared); });
+	measureCast(ctx, "shared_static_cast", "cat::SharedPtr", [&]() { return shared.asSharedStatic<BenchDerived>(); });
+
+	// down and back up again. Moving hands the reference over without touching the atomic usage count.
+	ConcurrentSharedPtr<BenchBase> concurrent = ConcurrentSharedPtr<BenchDerived>{{}, 1};
+	measureCast(ctx, "shared_cast_round_trip", "cat::ConcurrentSharedPtr (copy)", [&]() {
+		ConcurrentSharedPtr<BenchDerived> derived = concurrent.asSharedStatic<BenchDerived>();
+		concurrent = derived;
+		return concurrent.___getPtr();
+	});
+	measureCast(ctx, "shared_cast_round_trip", "cat::ConcurrentSharedPtr (move)", [&]() {
+		ConcurrentSharedPtr<BenchDerived> derived = std::move(concurrent).asSharedStatic<BenchDerived>();
+		concurrent = std::move(derived);
+		return concurrent.___getPtr();
+	});
+}
+CAT_DECLARE_BENCHMARK(bench_cast);
+
+
+void bench_vectorGrowth(Context& ctx) {
+	measureGrowth<RawSubject>(ctx);
+	measureGrowth<UniqueSubject>(ctx);
+	measureGrowth<OwningSubject>(ctx);
+	measureGrowth<SharedSubject>(ctx);
+	measureGrowth<CompactSharedSubject>(ctx);
+	measureGrowth<IntrusiveSubject>(ctx);
+}
+CAT_DECLARE_BENCHMARK(bench_vectorGrowth);
+
+
+void bench_tree(Context& ctx) {
+	std::pmr::monotonic_buffer_resource arena;
+	measureTree<HeapTreeNode>(ctx, "cat::OwningPtr");
+	measureTree<ArenaTreeNode>(ctx, "cat::ArenaOwningPtr", arena);
+	measureTree<SkippedArenaTreeNode>(ctx, "cat::ArenaOwningPtr (skip destruction)", arena);
+}
+CAT_DECLARE_BENCHMARK(bench_tree);
@@ -0,0 +1,79 @@
+#include "autoBench.h"
+
+#include "cat_sharedPtrArray.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t OBJECT_CNT = 1 << 20;
+
+struct Entry {
+	int values[8];
+	Entry(int v): values{v} {}
+};
+
+/**
+ * OBJECT_CNT objects in random memory order, each referenced runLength times in a row.
+ */
+template <class Counting_>
+std::vector<SharedPtr<Entry, Counting_>> makeEntries(size_t runLength) {
+	std::vector<SharedPtr<Entry, Counting_>> objects;
+	objects.reserve(OBJECT_CNT);
+	for (size_t i = 0; i < OBJECT_CNT; ++i) {
+		objects.emplace_back(InplaceConstructorTag{}, int(i));
+	}
+	std::shuffle(objects.begin(), objects.end(), std::mt19937(42));
+	std::vector<SharedPtr<Entry, Counting_>> entries;
+	entries.reserve(OBJECT_CNT * runLength);
+	for (const auto& object : objects) {
+		for (size_t i = 0; i < runLength; ++i) {
+			entries.push_back(object);
+		}
+	}
+	return entries;
+}
+
+template <class Counting_>
+void measureBulk(Context& ctx, const char* counting, size_t runLength) {
+	const auto entries = makeEntries<Counting_>(runLength);
+	const std::string suffix = std::string(" (") + counting + ", runs of " + std::to_string(runLength) + ")";
+
+	std::vector<SharedPtr<Entry, Counting_>> vector;
+	ctx.measure("snapshot", "std::vector<cat::SharedPtr>" + suffix, entries.size(),
+		[&]() { vector.clear(); },
+		[&]() { vector = entries; }
+	);
+	ctx.measure("clear", "std::vector<cat::SharedPtr>" + suffix, entries.size(),
+		[&]() { vector = entries; },
+		[&]() { vector.clear(); }
+	);
+
+	SharedPtrArray<Entry, Counting_> array;
+	array.append(entries.data(), entries.size());
+	SharedPtrArray<Entry, Counting_> snapshot;
+	ctx.measure("snapshot", "cat::SharedPtrArray" + suffix, entries.size(),
+		[&]() { snapshot.clear(); },
+		[&]() { snapshot = array; }
+	);
+	ctx.measure("clear", "cat::SharedPtrArray" + suffix, entries.size(),
+		[&]() { snapshot = array; },
+		[&]() { snapshot.clear(); }
+	);
+}
+
+}
+
+
+void bench_sharedPtrArray(Context& ctx) {
+	measureBulk<UnsyncedCounting>(ctx, "unsynced", 1);
+	measureBulk<AtomicCounting>(ctx, "atomic", 1);
+	measureBulk<AtomicCounting>(ctx, "atomic", 4);
+}
+CAT_DECLARE_BENCHMARK(bench_sharedPtrArray);
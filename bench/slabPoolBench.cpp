@@ -0,0 +1,109 @@
+#include "autoBench.h"
+
+#include "cat_sharedPtr.h"
+#include "cat_slabPool.h"
+
+#include <thread>
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t BATCH_SIZE = 4096;
+constexpr int THREAD_CNT = 4;
+
+struct HeapNode {
+	int payload[4];
+	HeapNode(int v): payload{v, v, v, v} {}
+};
+
+struct PooledNode {
+	int payload[4];
+	PooledNode(int v): payload{v, v, v, v} {}
+};
+CAT_POOLED_ALLOCATION(PooledNode)
+
+
+template <class T_>
+void measureChurn(Context& ctx, const char* subject) {
+	ctx.measure("shared_churn", subject, BATCH_SIZE, [&]() {
+		for (size_t i = 0; i < BATCH_SIZE; ++i) {
+			SharedPtr<T_> ptr{{}, int(i)};
+			doNotOptimize(ptr.___getPtr());
+		}
+	});
+}
+
+template <class T_>
+void measureBatch(Context& ctx, const char* subject) {
+	std::vector<SharedPtr<T_>> ptrs;
+	ptrs.reserve(BATCH_SIZE);
+	ctx.measure("shared_batch", subject, BATCH_SIZE, [&]() {
+		for (size_t i = 0; i < BATCH_SIZE; ++i) {
+			ptrs.emplace_back(InplaceConstructorTag{}, int(i));
+		}
+		ptrs.clear();
+	});
+}
+
+/**
+ * Every thread allocates a batch and another thread frees it, so blocks keep
+ * travelling between the threads.
+ */
+template <class T_>
+void measureThreads(Context& ctx, const char* subject) {
+	using Ptr = SharedPtr<T_, AtomicCounting>;
+	ctx.measure("shared_threads", subject, BATCH_SIZE * THREAD_CNT, [&]() {
+		std::vector<std::vector<Ptr>> batches(THREAD_CNT);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREAD_CNT; ++t) {
+			threads.emplace_back([&batches, t]() {
+				for (size_t i = 0; i < BATCH_SIZE; ++i) {
+					batches[t].emplace_back(InplaceConstructorTag{}, int(i));
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		threads.clear();
+		for (int t = 0; t < THREAD_CNT; ++t) {
+			threads.emplace_back([&batches, t]() {
+				batches[(t + 1) % THREAD_CNT].clear();
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	});
+}
+
+}
+
+
+void bench_slabPool(Context& ctx) {
+	using Pool = SlabPool<32, 8>;
+	std::vector<void*> blocks(BATCH_SIZE);
+	ctx.measure("allocate", "::operator new", BATCH_SIZE, [&]() {
+		for (auto& block : blocks) { block = ::operator new(32); }
+		for (auto& block : blocks) { ::operator delete(block); }
+	});
+	ctx.measure("allocate", "cat::SlabPool", BATCH_SIZE, [&]() {
+		for (auto& block : blocks) { block = Pool::allocate(); }
+		for (auto& block : blocks) { Pool::deallocate(block); }
+	});
+}
+CAT_DECLARE_BENCHMARK(bench_slabPool);
+
+
+void bench_pooledSharedPtr(Context& ctx) {
+	measureChurn<HeapNode>(ctx, "cat::SharedPtr");
+	measureChurn<PooledNode>(ctx, "cat::SharedPtr (pooled)");
+	measureBatch<HeapNode>(ctx, "cat::SharedPtr");
+	measureBatch<PooledNode>(ctx, "cat::SharedPtr (pooled)");
+	measureThreads<HeapNode>(ctx, "cat::ConcurrentSharedPtr");
+	measureThreads<PooledNode>(ctx, "cat::ConcurrentSharedPtr (pooled)");
+}
+CAT_DECLARE_BENCHMARK(bench_pooledSharedPtr);
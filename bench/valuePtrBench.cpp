@@ -0,0 +1,88 @@
+#include "autoBench.h"
+
+#include "cat_owningPtr.h"
+#include "cat_valuePtr.h"
+
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t SHAPE_CNT = 10000;
+
+struct Shape {
+	virtual ~Shape() = default;
+	virtual double area() const = 0;
+};
+
+struct Circle: Shape {
+	double radius;
+	Circle(double radius): radius(radius) {}
+	double area() const override { return 3.14159 * radius * radius; }
+};
+
+struct Rect: Shape {
+	double width, height;
+	Rect(double width, double height): width(width), height(height) {}
+	double area() const override { return width * height; }
+};
+
+}
+
+
+void bench_valuePtr(Context& ctx) {
+	ctx.reportSizeof<OwningPtr<Shape>>("cat::OwningPtr<Shape>");
+	ctx.reportSizeof<ValuePtr<Shape>>("cat::ValuePtr<Shape>");
+
+	ctx.measure("create", "cat::OwningPtr", SHAPE_CNT, [&]() {
+		std::vector<OwningPtr<Shape>> shapes;
+		shapes.reserve(SHAPE_CNT);
+		for (size_t i = 0; i < SHAPE_CNT; ++i) {
+			if (i % 2 == 0) {
+				shapes.push_back(OwningPtr<Circle>({}, double(i)));
+			} else {
+				shapes.push_back(OwningPtr<Rect>({}, double(i), 2.0));
+			}
+		}
+		doNotOptimize(shapes.data());
+	});
+
+	ctx.measure("create", "cat::ValuePtr", SHAPE_CNT, [&]() {
+		std::vector<ValuePtr<Shape>> shapes;
+		shapes.reserve(SHAPE_CNT);
+		for (size_t i = 0; i < SHAPE_CNT; ++i) {
+			if (i % 2 == 0) {
+				shapes.push_back(ValuePtr<Shape>::make<Circle>(double(i)));
+			} else {
+				shapes.push_back(ValuePtr<Shape>::make<Rect>(double(i), 2.0));
+			}
+		}
+		doNotOptimize(shapes.data());
+	});
+
+	std::vector<OwningPtr<Shape>> owningShapes;
+	std::vector<ValuePtr<Shape>> valueShapes;
+	for (size_t i = 0; i < SHAPE_CNT; ++i) {
+		owningShapes.push_back(OwningPtr<Circle>({}, double(i)));
+		valueShapes.push_back(ValuePtr<Shape>::make<Circle>(double(i)));
+	}
+
+	ctx.measure("iterate", "cat::OwningPtr", SHAPE_CNT, [&]() {
+		double total = 0;
+		for (const auto& shape : owningShapes) {
+			total += shape->area();
+		}
+		doNotOptimize(total);
+	});
+
+	ctx.measure("iterate", "cat::ValuePtr", SHAPE_CNT, [&]() {
+		double total = 0;
+		for (const auto& shape : valueShapes) {
+			total += shape->area();
+		}
+		doNotOptimize(total);
+	});
+}
+CAT_DECLARE_BENCHMARK(bench_valuePtr);
@@ -0,0 +1,102 @@
+#include "autoBench.h"
+
+#include "cat_owningPtr.h"
+#include "cat_sharedPtr.h"
+#include "cat_vector.h"
+
+#include <vector>
+
+using namespace cat;
+using namespace cat::autoBench;
+
+namespace {
+
+constexpr size_t CHILD_CNT = 10000;
+constexpr size_t ERASE_CNT = 1000;
+
+struct Node {
+	int value;
+	Node(int value): value(value) {}
+};
+
+template <class Ptr_>
+Ptr_ makeChild(int value) {
+	return Ptr_({}, value);
+}
+
+/**
+ * Moves CHILD_CNT children into an empty vector without reserve(), so the
+ * time is spent relocating the elements on growth. The children are moved
+ * back to the source list untimed.
+ */
+template <class Vector_>
+void measureGrowth(Context& ctx, const char* subject) {
+	using Ptr = typename Vector_::value_type;
+	std::vector<Ptr> source;
+	for (size_t i = 0; i < CHILD_CNT; ++i) {
+		source.push_back(makeChild<Ptr>(int(i)));
+	}
+	Vector_ children;
+	ctx.measure("growth", subject, CHILD_CNT,
+		[&]() {
+			for (size_t i = 0; i < children.size(); ++i) {
+				source[i] = std::move(children[i]);
+			}
+			children = Vector_();
+		},
+		[&]() {
+			for (auto& child : source) {
+				children.push_back(std::move(child));
+			}
+			doNotOptimize(children.data());
+		}
+	);
+}
+
+/**
+ * Removes ERASE_CNT children from the middle of a list of CHILD_CNT
+ * children. They are parked in a side list (and put back untimed), so no
+ * Node is destroyed in the timed part.
+ */
+template <class Vector_>
+void measureEraseMiddle(Context& ctx, const char* subject) {
+	using Ptr = typename Vector_::value_type;
+	Vector_ children;
+	for (size_t i = 0; i < CHILD_CNT; ++i) {
+		children.push_back(makeChild<Ptr>(int(i)));
+	}
+	std::vector<Ptr> parked;
+	parked.reserve(ERASE_CNT);
+	ctx.measure("erase_middle", subject, ERASE_CNT,
+		[&]() {
+			for (auto& child : parked) {
+				children.push_back(std::move(child));
+			}
+			parked.clear();
+		},
+		[&]() {
+			for (size_t i = 0; i < ERASE_CNT; ++i) {
+				const size_t middle = children.size() / 2;
+				parked.push_back(std::move(children[middle]));
+				children.erase(children.begin() + middle);
+			}
+			doNotOptimize(children.data());
+		}
+	);
+}
+
+}
+
+
+void bench_vector(Context& ctx) {
+	measureGrowth<std::vector<OwningPtr<Node>>>(ctx, "std::vector<cat::OwningPtr>");
+	measureGrowth<Vector<OwningPtr<Node>>>(ctx, "cat::Vector<cat::OwningPtr>");
+	measureGrowth<std::vector<SharedPtr<Node>>>(ctx, "std::vector<cat::SharedPtr>");
+	measureGrowth<Vector<SharedPtr<Node>>>(ctx, "cat::Vector<cat::SharedPtr>");
+
+	measureEraseMiddle<std::vector<OwningPtr<Node>>>(ctx, "std::vector<cat::OwningPtr>");
+	measureEraseMiddle<Vector<OwningPtr<Node>>>(ctx, "cat::Vector<cat::OwningPtr>");
+	measureEraseMiddle<std::vector<SharedPtr<Node>>>(ctx, "std::vector<cat::SharedPtr>");
+	measureEraseMiddle<Vector<SharedPtr<Node>>>(ctx, "cat::Vector<cat::SharedPtr>");
+}
+CAT_DECLARE_BENCHMARK(bench_vector);
@@ -4,16 +4,24 @@
 #include "cat_weakPtr.h"
 #include "cat_owningPtr.h"
 #include "cat_sharedPtr.h"
+#include "cat_intrusivePtr.h"
+#include "cat_valuePtr.h"
 
 namespace cat {
 
-#define ADD_PTR_TYPES(Cls)                             \
-	using Cls##Ptr = cat::OwningPtr<Cls>;              \
-	using Cls##CPtr = cat::OwningPtr<const Cls>;       \
-	using Cls##WeakPtr = cat::WeakPtr<Cls>;            \
-	using Cls##CWeakPtr = cat::WeakPtr<const Cls>;     \
-	using Cls##SharedPtr = cat::SharedPtr<Cls>;        \
-	using Cls##CSharedPtr = cat::SharedPtr<const Cls>;
+#define ADD_PTR_TYPES(Cls)                                                 \
+	using Cls##Ptr = cat::OwningPtr<Cls>;                                  \
+	using Cls##CPtr = cat::OwningPtr<const Cls>;                           \
+	using Cls##WeakPtr = cat::WeakPtr<Cls>;                                \
+	using Cls##CWeakPtr = cat::WeakPtr<const Cls>;                         \
+	using Cls##SharedPtr = cat::SharedPtr<Cls>;                            \
+	using Cls##CSharedPtr = cat::SharedPtr<const Cls>;                     \
+	using Cls##ConcurrentSharedPtr = cat::ConcurrentSharedPtr<Cls>;        \
+	using Cls##CConcurrentSharedPtr = cat::ConcurrentSharedPtr<const Cls>; \
+	using Cls##IntrusivePtr = cat::IntrusivePtr<Cls>;                      \
+	using Cls##CIntrusivePtr = cat::IntrusivePtr<const Cls>;               \
+	using Cls##ValuePtr = cat::ValuePtr<Cls>;                              \
+	using Cls##CValuePtr = cat::ValuePtr<const Cls>;
 
 #define PTRS_FOR_STRUCT(Cls) \
 	struct Cls;              \
@@ -0,0 +1,190 @@
+#ifndef CAT_ATOMICSHAREDPTR_H
+#define CAT_ATOMICSHAREDPTR_H
+
+#include "cat_sharedPtr.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+namespace cat {
+
+/**
+ * AtomicSharedPtr is a slot that holds a SharedPtr and can be read and
+ * written from several threads at once without a lock. It is meant for
+ * read-mostly data, that is published once in a while:
+ *   AtomicSharedPtr<const Table> table;
+ *   table.store(ConcurrentSharedPtr<const Table>{{}, ...}); // writer
+ *   ConcurrentSharedPtr<const Table> snapshot = table.load(); // readers
+ *
+ * It uses split reference counting: The slot points to a small node, that
+ * holds the SharedPtr. The pointer to the node is packed into one 64 bit
+ * word together with an external count of readers, that are currently
+ * copying the SharedPtr out of the node. A reader increments the external
+ * count, copies the SharedPtr and decrements it again. If the node has been
+ * replaced in the meantime, the reader decrements the internal count of the
+ * node instead. The writer, that replaced the node, adds the external count
+ * to the internal count, so whoever brings it to zero deletes the node.
+ *
+ * Every store() allocates a node (except for nullptr). Up to 65535 readers
+ * may be inside load() at the same time.
+ */
+template <class T_, class Counting_ = AtomicCounting>
+struct AtomicSharedPtr {
+	static_assert(sizeof(void*) == sizeof(uint64_t), "AtomicSharedPtr packs a 48 bit pointer into a 64 bit word.");
+	static_assert(Counting_::IS_THREAD_SAFE, "AtomicSharedPtr needs a thread-safe counting policy, e.g. AtomicCounting.");
+public:
+	using T = T_;
+	using Counting = Counting_;
+	using Value = SharedPtr<T, Counting>;
+
+private:
+	struct Node_ {
+		Value value;
+		std::atomic<std::ptrdiff_t> internalCnt;
+
+		explicit Node_(Value&& value) : value(std::move(value)), internalCnt(0) {}
+	};
+
+	static constexpr int PTR_BITS = 48;
+	static constexpr uint64_t PTR_MASK = (uint64_t(1) << PTR_BITS) - 1;
+	static constexpr uint64_t ONE_READER = uint64_t(1) << PTR_BITS;
+
+	mutable std::atomic<uint64_t> _word;
+
+public:
+	AtomicSharedPtr() noexcept : _word(0) {}
+	AtomicSharedPtr(std::nullptr_t) noexcept : _word(0) {}
+	AtomicSharedPtr(Value desired) : _word(_pack(_makeNode(std::move(desired)))) {}
+
+	AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+	AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+	~AtomicSharedPtr() {
+		delete _getNode(_word.load(std::memory_order_acquire));
+	}
+
+public:
+	Value load() const {
+		const uint64_t word = _acquire();
+		Node_* node = _getNode(word);
+		Value result = node != nullptr ? node->value : Value(nullptr);
+		_release(node);
+		return result;
+	}
+
+	void store(Value desired) {
+		exchange(std::move(desired));
+	}
+
+	Value exchange(Value desired) {
+		const uint64_t oldWord = _word.exchange(_pack(_makeNode(std::move(desired))), std::memory_order_acq_rel);
+		Node_* oldNode = _getNode(oldWord);
+		if (oldNode == nullptr) {
+			return nullptr;
+		}
+		// readers may still be copying oldNode->value, so it must not be modified.
+		Value result = oldNode->value;
+		_retire(oldNode, _getReaderCnt(oldWord));
+		return result;
+	}
+
+	/**
+	 *  @brief  Replaces the value with desired, if it is the same as expected
+	 *  (same control block and same target). Otherwise expected is set to the
+	 *  current value.
+	 */
+	bool compare_exchange(Value& expected, Value desired) {
+		Node_* newNode = _makeNode(std::move(desired));
+		while (true) {
+			uint64_t oldWord = _acquire();
+			Node_* oldNode = _getNode(oldWord);
+			const Value& current = oldNode != nullptr ? oldNode->value : _null();
+			if (not _isSame(current, expected)) {
+				expected = current;
+				_release(oldNode);
+				delete newNode;
+				return false;
+			}
+			if (_word.compare_exchange_strong(oldWord, _pack(newNode), std::memory_order_acq_rel, std::memory_order_relaxed)) {
+				// the reader count of oldWord includes this thread.
+				if (oldNode != nullptr) {
+					_retire(oldNode, _getReaderCnt(oldWord) - 1);
+				}
+				return true;
+			}
+			_release(oldNode);
+		}
+	}
+
+	bool is_lock_free() const noexcept {
+		return _word.is_lock_free();
+	}
+
+private:
+	static Node_* _makeNode(Value&& value) {
+		return value != nullptr ? new Node_(std::move(value)) : nullptr;
+	}
+
+	static uint64_t _pack(Node_* node) noexcept {
+		return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(node));
+	}
+
+	static Node_* _getNode(uint64_t word) noexcept {
+		return reinterpret_cast<Node_*>(static_cast<uintptr_t>(word & PTR_MASK));
+	}
+
+	static std::ptrdiff_t _getReaderCnt(uint64_t word) noexcept {
+		return static_cast<std::ptrdiff_t>(word >> PTR_BITS);
+	}
+
+	static const Value& _null() noexcept {
+		static const Value null = nullptr;
+		return null;
+	}
+
+	static bool _isSame(const Value& a, const Value& b) noexcept {
+		return a == b && a.___getPtr() == b.___getPtr();
+	}
+
+	/**
+	 *  @brief  Registers this thread as a reader of the current node, so it
+	 *  won't be deleted until _release() is called.
+	 */
+	uint64_t _acquire() const noexcept {
+		return _word.fetch_add(ONE_READER, std::memory_order_acquire) + ONE_READER;
+	}
+
+	/**
+	 *  @brief  The reader count of a null word has no meaning, so it does
+	 *  not matter, if it is decremented after a null was stored once more.
+	 */
+	void _release(Node_* node) const noexcept {
+		uint64_t word = _word.load(std::memory_order_relaxed);
+		while (_getNode(word) == node) {
+			if (_word.compare_exchange_weak(word, word - ONE_READER, std::memory_order_release, std::memory_order_relaxed)) {
+				return;
+			}
+		}
+		// node has been replaced. The writer moved our count to the internal count.
+		if (node != nullptr && node->internalCnt.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete node;
+		}
+	}
+
+	/**
+	 *  @brief  Deletes node, once all of its readerCnt readers are done.
+	 */
+	static void _retire(Node_* node, std::ptrdiff_t readerCnt) noexcept {
+		if (node->internalCnt.fetch_add(readerCnt, std::memory_order_acq_rel) + readerCnt == 0) {
+			delete node;
+		}
+	}
+};
+
+}
+
+
+#endif // CAT_ATOMICSHAREDPTR_H
@@ -0,0 +1,304 @@
+#ifndef CAT_BIASEDCOUNTING_H
+#define CAT_BIASEDCOUNTING_H
+
+#include "cat_sharedPtr.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace cat {
+
+/**
+ * BiasedCounting is a counting policy for SharedPtrs that are mostly used by
+ * the thread that created them (the owner), but may occasionally be shared
+ * with other threads.
+ *
+ * The owner thread modifies a plain (biased) count, all other threads
+ * modify an atomic (shared) count. The two counts are merged, when the
+ * biased count drops to zero. If the shared count becomes negative before
+ * that (another thread released references that the owner handed out), the
+ * control block is queued at its owner, which merges the counts on its next
+ * slow path (creating a control block, draining a biased count or calling
+ * mergeQueued()) or when it exits.
+ *
+ * Only control blocks that derive from BasicSharedPtrRefCnt_ can use it.
+ */
+struct BiasedCounting {
+	using CntT = size_t;
+	static constexpr bool HAS_WEAK_CNT = false;
+	static constexpr bool IS_THREAD_SAFE = true;
+	/** @brief  load() misses the biased count on other threads, see load(). */
+	static constexpr bool IS_LOAD_EXACT = false;
+
+private:
+	struct Owner_;
+
+	static constexpr intptr_t QUEUED = 1;
+	static constexpr intptr_t MERGED = 2;
+	static constexpr int FLAG_BITS = 2;
+	static constexpr intptr_t ONE = intptr_t(1) << FLAG_BITS;
+
+public:
+	struct StorageT {
+	private:
+		Owner_* const owner;
+		CntT biased;
+		/**
+		 * The shared count times ONE plus the QUEUED and MERGED flags. It may
+		 * become negative.
+		 */
+		std::atomic<intptr_t> shared;
+		StorageT* nextQueued;
+
+		friend struct BiasedCounting;
+
+	public:
+		StorageT(CntT usageCnt)
+			: owner(_getOrCreateOwner()),
+			  biased(owner != _exitedOwner() ? usageCnt : 0),
+			  shared(owner != _exitedOwner() ? 0 : static_cast<intptr_t>(usageCnt) * ONE | MERGED),
+			  nextQueued(nullptr)
+		{}
+
+		~StorageT() {
+			_releaseOwner(owner);
+		}
+	};
+
+private:
+	/**
+	 * One per thread. Control blocks keep pointing to it after the thread
+	 * has exited, so it is freed once the thread has exited and all of its
+	 * control blocks are gone.
+	 */
+	struct Owner_ {
+		std::atomic<StorageT*> queue{nullptr};
+		/**
+		 * The number of control blocks, biased like their counts: the thread
+		 * modifies localBlockCnt, everyone else blockCnt. blockCnt starts at
+		 * ALIVE, so it can't drop to zero before the thread has exited and
+		 * moved localBlockCnt into it.
+		 */
+		intptr_t localBlockCnt = 0;
+		std::atomic<intptr_t> blockCnt{ALIVE};
+
+		static constexpr intptr_t ALIVE = intptr_t(1) << (sizeof(intptr_t) * 8 - 2);
+	};
+
+	/**
+	 * Closes the queue of its thread on thread exit.
+	 */
+	struct OwnerCloser_ {
+		~OwnerCloser_() {
+			Owner_* owner = _currentOwner();
+			_currentOwner() = nullptr;
+			_isExited() = true;
+			_mergeAll(owner->queue.exchange(_closed(), std::memory_order_acq_rel));
+			const intptr_t transfer = owner->localBlockCnt - Owner_::ALIVE;
+			if (owner->blockCnt.fetch_add(transfer, std::memory_order_acq_rel) + transfer == 0) {
+				delete owner;
+			}
+		}
+	};
+
+public:
+	/**
+	 *  @brief  Exact only on the owner thread or after the counts were merged.
+	 */
+	static inline CntT load(const StorageT& cnt) noexcept {
+		const intptr_t shared = cnt.shared.load(std::memory_order_relaxed);
+		if (_isBiased(cnt, shared)) {
+			return cnt.biased + _getCnt(shared);
+		}
+		return static_cast<CntT>(_getCnt(shared));
+	}
+
+	static inline void increment(StorageT& cnt) noexcept {
+		if (_isBiased(cnt, cnt.shared.load(std::memory_order_relaxed))) {
+			cnt.biased += 1;
+		} else {
+			cnt.shared.fetch_add(ONE, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 *  @brief  Returns true, if the count dropped to zero.
+	 */
+	static inline bool decrement(StorageT& cnt) noexcept {
+		if (_isBiased(cnt, cnt.shared.load(std::memory_order_relaxed))) {
+			cnt.biased -= 1;
+			return cnt.biased == 0 && _mergeDrained(cnt);
+		}
+		return _decrementShared(cnt);
+	}
+
+	/**
+	 *  @brief  Merges the counts of all control blocks, that were queued at
+	 *  the current thread. Control blocks that are no longer used are disposed.
+	 */
+	static void mergeQueued() {
+		Owner_* owner = _currentOwner();
+		if (owner != nullptr && owner->queue.load(std::memory_order_relaxed) != nullptr) {
+			_mergeAll(owner->queue.exchange(nullptr, std::memory_order_acquire));
+		}
+	}
+
+private:
+	static Owner_*& _currentOwner() noexcept {
+		static thread_local Owner_* owner = nullptr;
+		return owner;
+	}
+
+	static bool& _isExited() noexcept {
+		static thread_local bool isExited = false;
+		return isExited;
+	}
+
+	static StorageT* _closed() noexcept {
+		return reinterpret_cast<StorageT*>(alignof(StorageT));
+	}
+
+	/**
+	 *  @brief  Shared by all control blocks created during thread exit. Its
+	 *  queue is closed, and it is nobody's current owner.
+	 */
+	static Owner_* _exitedOwner() noexcept {
+		static Owner_ exited{_closed()};
+		return &exited;
+	}
+
+	static void _releaseOwner(Owner_* owner) noexcept {
+		if (owner == _currentOwner()) {
+			owner->localBlockCnt -= 1;
+		} else if (owner != _exitedOwner() && owner->blockCnt.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete owner;
+		}
+	}
+
+	static Owner_* _getOrCreateOwner() {
+		Owner_*& owner = _currentOwner();
+		if (owner != nullptr) {
+			mergeQueued();
+			owner->localBlockCnt += 1;
+			return owner;
+		}
+		if (_isExited()) {
+			// control blocks created during thread exit are never biased, they start merged.
+			return _exitedOwner();
+		}
+		owner = new Owner_();
+		owner->localBlockCnt += 1;
+		static thread_local OwnerCloser_ closer;
+		(void)closer;
+		return owner;
+	}
+
+	static inline intptr_t _getCnt(intptr_t shared) noexcept {
+		return shared >> FLAG_BITS; // rounds towards negative infinity, unlike /.
+	}
+
+	static inline bool _isBiased(const StorageT& cnt, intptr_t shared) noexcept {
+		return cnt.owner == _currentOwner() && (shared & MERGED) == 0;
+	}
+
+	/**
+	 *  @brief  Called by the owner, when the biased count dropped to zero.
+	 */
+	CAT_NOINLINE static bool _mergeDrained(StorageT& cnt) noexcept {
+		const intptr_t old = cnt.shared.fetch_or(MERGED, std::memory_order_acq_rel);
+		mergeQueued();
+		// a queued control block is disposed, once it has been taken out of the queue.
+		return _getCnt(old) == 0 && (old & QUEUED) == 0;
+	}
+
+	CAT_NOINLINE static bool _decrementShared(StorageT& cnt) noexcept {
+		intptr_t old = cnt.shared.load(std::memory_order_relaxed);
+		while (true) {
+			if (old & MERGED) {
+				const intptr_t now = cnt.shared.fetch_sub(ONE, std::memory_order_acq_rel) - ONE;
+				return _getCnt(now) == 0 && (now & QUEUED) == 0;
+			}
+			intptr_t now = old - ONE;
+			const bool needsQueue = now < 0 && (old & QUEUED) == 0;
+			if (needsQueue) {
+				now |= QUEUED;
+			}
+			if (cnt.shared.compare_exchange_weak(old, now, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+				if (needsQueue) {
+					_enqueue(cnt);
+				}
+				return false;
+			}
+		}
+	}
+
+	static void _enqueue(StorageT& cnt) noexcept {
+		std::atomic<StorageT*>& queue = cnt.owner->queue;
+		StorageT* head = queue.load(std::memory_order_acquire);
+		while (true) {
+			if (head == _closed()) {
+				// the owner has exited, so its biased count won't change anymore.
+				_merge(cnt);
+				return;
+			}
+			cnt.nextQueued = head;
+			if (queue.compare_exchange_weak(head, &cnt, std::memory_order_release, std::memory_order_acquire)) {
+				return;
+			}
+		}
+	}
+
+	static void _mergeAll(StorageT* queued) noexcept {
+		while (queued != nullptr) {
+			StorageT* next = queued->nextQueued;
+			_merge(*queued);
+			queued = next;
+		}
+	}
+
+	/**
+	 *  @brief  Adds the biased count to the shared count (unless that has
+	 *  already happened) and takes the control block out of the queue.
+	 */
+	static void _merge(StorageT& cnt) noexcept {
+		intptr_t old = cnt.shared.load(std::memory_order_relaxed);
+		intptr_t now;
+		do {
+			now = old & ~QUEUED;
+			if ((old & MERGED) == 0) {
+				now = (now + static_cast<intptr_t>(cnt.biased) * ONE) | MERGED;
+			}
+		} while (not cnt.shared.compare_exchange_weak(old, now, std::memory_order_acq_rel, std::memory_order_relaxed));
+		if (_getCnt(now) == 0) {
+			_dispose(cnt);
+		}
+	}
+
+	static void _dispose(StorageT& cnt) noexcept {
+		using RefCnt = _sharedPtr_internal::BasicSharedPtrRefCnt_<BiasedCounting>;
+		static_assert(std::is_standard_layout_v<RefCnt>, "The count must be the first member of the control block.");
+		reinterpret_cast<RefCnt*>(&cnt)->dispose();
+	}
+};
+
+/**
+ * The weak count of an ObservableCounting<BiasedCounting> could not be
+ * queued at its owner.
+ */
+template <>
+struct ObservableCounting<BiasedCounting>;
+
+/**
+ * A SharedPtr that is cheap to copy on the thread that created it and still
+ * safe to share with other threads.
+ */
+template <class T_>
+using BiasedSharedPtr = SharedPtr<T_, BiasedCounting>;
+
+}
+
+
+#endif // CAT_BIASEDCOUNTING_H
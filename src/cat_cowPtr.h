@@ -0,0 +1,136 @@
+#ifndef CAT_COWPTR_H
+#define CAT_COWPTR_H
+
+#include "cat_sharedPtr.h"
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+
+namespace cat {
+
+/**
+ * A copy-on-write value. Copies of a CowPtr share one payload. Const access
+ * is free; getMutable() first copies the payload into a new inplace control
+ * block, if it is shared (see isUnique()).
+ * e.g.:
+ *   CowPtr<Document> doc{{}, ...};
+ *   CowPtr<Document> stage2 = doc; // no deep copy.
+ *   stage2.getMutable().title = "..."; // copies the Document once.
+ *
+ * The payload is copied as a T, so it must not be of a subclass of T.
+ */
+template <class T_, class Counting_ = UnsyncedCounting>
+class CowPtr {
+public:
+	using T = T_;
+	using Counting = Counting_;
+
+	static_assert(not std::is_const_v<T>, "A CowPtr is always const, unless it is unique.");
+	static_assert(Counting::IS_LOAD_EXACT, "isUnique() needs a counting policy whose load() is exact on every thread, e.g. not BiasedCounting.");
+
+private:
+	SharedPtr<T, Counting> _ptr;
+
+public:
+	CowPtr(std::nullptr_t) noexcept : _ptr(nullptr) {}
+
+	template <typename... Args>
+	explicit CowPtr(InplaceConstructorTag, Args&& ...args)
+		: _ptr(InplaceConstructorTag{}, std::forward<Args>(args)...)
+	{}
+
+	/**
+	 *  @brief  From now on, ptr (and its copies) must not be used to modify the payload.
+	 */
+	explicit CowPtr(SharedPtr<T, Counting> ptr) noexcept
+		: _ptr(std::move(ptr))
+	{}
+
+	CowPtr(const CowPtr& other) = default;
+	CowPtr(CowPtr&& other) noexcept = default;
+	CowPtr& operator =(const CowPtr& other) = default;
+	CowPtr& operator =(CowPtr&& other) noexcept = default;
+
+	inline void swap(CowPtr& other) noexcept {
+		_ptr.swap(other._ptr);
+	}
+
+	/**
+	 *  @brief  True, if no other SharedPtr (or ObserverPtr) refers to the payload,
+	 *  so it can be modified in place. A null CowPtr is not unique.
+	 */
+	bool isUnique() const noexcept {
+		const auto* refCnt = _ptr._ptrData.refCnt.___getPtr();
+		if (refCnt == nullptr) {
+			return false;
+		}
+		if constexpr (Counting::HAS_WEAK_CNT) {
+			// the weak count first: an ObserverPtr on another thread may lock() the
+			// payload (usage 1 -> 2) and then be released (weak 2 -> 1). Acquiring
+			// the weak count makes that lock() visible to the usage count below.
+			if (refCnt->getWeakCntAcquire() != 1) {
+				return false;
+			}
+		}
+		// acquired, so the accesses of other threads to the payload happen before they released it.
+		return refCnt->getUsageCntAcquire() == 1;
+	}
+
+	/**
+	 *  @brief  Copies the payload, unless it is unique.
+	 */
+	void makeUnique() {
+		if (_ptr != nullptr and not isUnique()) {
+			_ptr = SharedPtr<T, Counting>(InplaceConstructorTag{}, std::as_const(*_ptr));
+		}
+	}
+
+	/**
+	 *  @brief  Makes the payload unique and returns it. The reference is
+	 *  valid until this CowPtr is copied.
+	 */
+	T& getMutable() {
+		makeUnique();
+		return *_ptr.___getPtr();
+	}
+
+	inline const T& operator *() const noexcept { return *___getPtr(); }
+	inline const T* operator ->() const noexcept { return ___getPtr(); }
+
+	WeakPtr<const T> getWeak() const {
+		return WeakPtr<const T>(___getPtr());
+	}
+
+	inline bool operator ==(const CowPtr& other) const noexcept { return _ptr == other._ptr; }
+	inline bool operator ==(std::nullptr_t) const noexcept { return _ptr == nullptr; }
+
+	inline bool operator !=(const CowPtr& other) const noexcept { return _ptr != other._ptr; }
+	inline bool operator !=(std::nullptr_t) const noexcept { return _ptr != nullptr; }
+
+	explicit operator bool () const noexcept { return _ptr != nullptr; }
+
+	inline const T* ___getPtr() const noexcept {
+		return _ptr.___getPtr();
+	}
+};
+
+template <class T_>
+using ConcurrentCowPtr = CowPtr<T_, AtomicCounting>;
+
+template <class T_, class Counting_>
+struct IsTriviallyRelocatable<CowPtr<T_, Counting_>>: std::true_type {};
+
+}
+
+template <class T_, class Counting_>
+struct std::hash<cat::CowPtr<T_, Counting_>> {
+	size_t operator()(const cat::CowPtr<T_, Counting_>& v) const noexcept {
+		return std::hash<const T_*>()(v.___getPtr());
+	}
+};
+
+
+#endif // CAT_COWPTR_H
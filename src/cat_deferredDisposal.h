@@ -0,0 +1,377 @@
+#ifndef CAT_DEFERREDDISPOSAL_H
+#define CAT_DEFERREDDISPOSAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace cat {
+
+/**
+ * Fallback for the opt-in below. A type opts in by declaring an overload
+ * of this function next to it (found through ADL), which is what
+ * CAT_DEFERRED_DISPOSAL(Cls) does. Types derived from an opted-in type are
+ * deferred as well.
+ */
+constexpr bool ___catUseDeferredDisposal(const void*) noexcept { return false; }
+
+/**
+ * Decides whether the payload of a SharedPtr to T_ is destroyed by
+ * cat::reclaim() instead of by whoever releases the last reference. May also
+ * be specialized directly.
+ */
+template <class T_>
+struct UseDeferredDisposal: std::bool_constant<___catUseDeferredDisposal(static_cast<const T_*>(nullptr))> {};
+
+template <class T_>
+inline constexpr bool useDeferredDisposal_v = UseDeferredDisposal<T_>::value;
+
+/**
+ * Opts Cls into deferred disposal. Use it in the namespace of Cls, e.g. right
+ * after PTRS_FOR_CLASS(Cls).
+ */
+#define CAT_DEFERRED_DISPOSAL(Cls) \
+	constexpr bool ___catUseDeferredDisposal(const Cls*) noexcept { return true; }
+
+
+struct DeferredDisposalStats {
+	/** Deferred, but not yet disposed. Includes the ones still buffered by their threads. */
+	size_t pending;
+	size_t reclaimed;
+	/** The number of reclaim() calls that disposed anything. */
+	size_t batches;
+	size_t lastBatchSize;
+	size_t maxBatchSize;
+};
+
+
+/**
+ * DeferredDisposal collects control blocks whose last reference has been
+ * released, so they can be disposed later by reclaim(), e.g. on a background
+ * thread.
+ *
+ * Every thread buffers up to BATCH_SIZE of them on its own and then pushes
+ * the whole batch onto a global lock-free stack. reclaim() also takes the
+ * partially filled buffers of all other threads, so a thread that defers a
+ * few objects and then goes idle doesn't hold them back. A thread publishes
+ * its buffer when it exits. Objects released after that are disposed right
+ * away.
+ */
+class DeferredDisposal {
+public:
+	using DisposeFn = void (*)(void* obj);
+	static constexpr size_t BATCH_SIZE = 64;
+
+private:
+	struct Entry_ {
+		void* obj;
+		DisposeFn dispose;
+	};
+
+	struct Batch_ {
+		Batch_* next;
+		size_t size;
+		Entry_ entries[BATCH_SIZE];
+	};
+
+	/**
+	 * Trivially destructible on purpose, so it can still be used after the
+	 * thread-exit flush (e.g. from destructors of other thread_locals).
+	 *
+	 * current is only ever set by its thread. Everyone takes it with an
+	 * exchange, so reclaim() on another thread can take it at any time.
+	 * draining is the batch that reclaim() on this thread is disposing, and
+	 * only ever touched by this thread.
+	 */
+	struct Local_ {
+		std::atomic<Batch_*> current{nullptr};
+		Batch_* draining = nullptr;
+		bool hasFlusher = false;
+		bool isFlushed = false;
+		Local_* nextLocal = nullptr;
+	};
+
+	struct Global_ {
+		std::atomic<Batch_*> batches{nullptr};
+		std::atomic<size_t> pending{0};
+		std::atomic<size_t> reclaimed{0};
+		std::atomic<size_t> batchCnt{0};
+		std::atomic<size_t> lastBatchSize{0};
+		std::atomic<size_t> maxBatchSize{0};
+		/** All threads that have a buffer, so reclaim() can take it. */
+		std::mutex localsMutex;
+		Local_* locals = nullptr;
+	};
+
+	struct LocalFlusher_ {
+		~LocalFlusher_() {
+			Local_& local = _local();
+			_unregister(local);
+			flush();
+			delete local.current.exchange(nullptr, std::memory_order_acquire); // empty, if anything.
+			local.isFlushed = true;
+		}
+	};
+
+public:
+	/**
+	 *  @brief  Schedules dispose(obj) for the next reclaim(). Returns false,
+	 *  if that is not possible (the thread is exiting or out of memory). The
+	 *  caller has to dispose obj right away then.
+	 */
+	static bool defer(void* obj, DisposeFn dispose) noexcept {
+		Local_& local = _local();
+		if (local.draining != nullptr && local.draining->size != BATCH_SIZE) {
+			local.draining->entries[local.draining->size++] = Entry_{obj, dispose};
+			_global().pending.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+		Batch_* batch = local.current.exchange(nullptr, std::memory_order_acquire);
+		if (batch == nullptr) {
+			if (local.isFlushed) {
+				return false;
+			}
+			batch = new (std::nothrow) Batch_;
+			if (batch == nullptr) {
+				return false;
+			}
+			batch->size = 0;
+			_ensureFlusher(local);
+		}
+		batch->entries[batch->size++] = Entry_{obj, dispose};
+		_global().pending.fetch_add(1, std::memory_order_relaxed);
+		if (batch->size == BATCH_SIZE) {
+			_pushBatch(batch);
+		} else {
+			local.current.store(batch, std::memory_order_release);
+		}
+		return true;
+	}
+
+	/**
+	 *  @brief  Makes the objects buffered by the current thread visible to
+	 *  reclaim() on other threads.
+	 */
+	static void flush() noexcept {
+		Local_& local = _local();
+		Batch_* batch = local.current.exchange(nullptr, std::memory_order_acquire);
+		if (batch != nullptr) {
+			if (batch->size != 0) {
+				_pushBatch(batch);
+			} else {
+				local.current.store(batch, std::memory_order_release);
+			}
+		}
+	}
+
+	/**
+	 *  @brief  Disposes all published objects and the ones buffered by any
+	 *  thread, including the ones that are released while doing so.
+	 *  Returns the number of disposed objects.
+	 */
+	static size_t reclaim() {
+		Global_& global = _global();
+		Local_& local = _local();
+		_takeOtherLocals(local);
+		size_t count = 0;
+		while (true) {
+			count += _drainLocal(local);
+			Batch_* batches = global.batches.exchange(nullptr, std::memory_order_acquire);
+			if (batches == nullptr) {
+				break;
+			}
+			while (batches != nullptr) {
+				Batch_* next = batches->next;
+				for (size_t i = 0; i < batches->size; ++i) {
+					batches->entries[i].dispose(batches->entries[i].obj);
+				}
+				count += batches->size;
+				delete batches;
+				batches = next;
+			}
+		}
+
+		if (count != 0) {
+			global.pending.fetch_sub(count, std::memory_order_relaxed);
+			global.reclaimed.fetch_add(count, std::memory_order_relaxed);
+			global.batchCnt.fetch_add(1, std::memory_order_relaxed);
+			global.lastBatchSize.store(count, std::memory_order_relaxed);
+			size_t maxBatchSize = global.maxBatchSize.load(std::memory_order_relaxed);
+			while (maxBatchSize < count && not global.maxBatchSize.compare_exchange_weak(maxBatchSize, count, std::memory_order_relaxed)) {}
+		}
+		return count;
+	}
+
+	static DeferredDisposalStats stats() noexcept {
+		const Global_& global = _global();
+		return DeferredDisposalStats{
+			global.pending.load(std::memory_order_relaxed),
+			global.reclaimed.load(std::memory_order_relaxed),
+			global.batchCnt.load(std::memory_order_relaxed),
+			global.lastBatchSize.load(std::memory_order_relaxed),
+			global.maxBatchSize.load(std::memory_order_relaxed),
+		};
+	}
+
+private:
+	static Global_& _global() {
+		static Global_& global = *new Global_(); // never destroyed, objects may be released during static destruction.
+		return global;
+	}
+
+	static Local_& _local() noexcept {
+		static thread_local Local_ local;
+		return local;
+	}
+
+	/**
+	 * Disposes the objects buffered by this thread in place (last in, first
+	 * out), so releasing a long chain of objects does not allocate a batch
+	 * per object.
+	 */
+	static size_t _drainLocal(Local_& local) {
+		size_t count = 0;
+		while (Batch_* batch = local.current.exchange(nullptr, std::memory_order_acquire)) {
+			if (batch->size == 0) {
+				_putBack(local, batch);
+				break;
+			}
+			local.draining = batch;
+			while (batch->size != 0) {
+				const Entry_ entry = batch->entries[--batch->size];
+				entry.dispose(entry.obj); // may defer more objects (into batch, while it has room).
+				count += 1;
+			}
+			local.draining = nullptr;
+			_putBack(local, batch);
+		}
+		return count;
+	}
+
+	/**
+	 * Keeps an empty batch for the next defer(), unless the thread has
+	 * started a new one in the meantime.
+	 */
+	static void _putBack(Local_& local, Batch_* batch) noexcept {
+		if (local.current.load(std::memory_order_relaxed) == nullptr) {
+			local.current.store(batch, std::memory_order_release);
+		} else {
+			delete batch;
+		}
+	}
+
+	/**
+	 * Publishes the partially filled buffers of all other threads. Their
+	 * threads start new ones.
+	 */
+	static void _takeOtherLocals(const Local_& self) {
+		Global_& global = _global();
+		std::lock_guard<std::mutex> lock(global.localsMutex);
+		for (Local_* local = global.locals; local != nullptr; local = local->nextLocal) {
+			if (local == &self || local->current.load(std::memory_order_relaxed) == nullptr) {
+				continue;
+			}
+			Batch_* batch = local->current.exchange(nullptr, std::memory_order_acquire);
+			if (batch == nullptr) {
+				continue;
+			}
+			if (batch->size != 0) {
+				_pushBatch(batch);
+			} else {
+				delete batch; // its thread can't get it back, it may have started a new one already.
+			}
+		}
+	}
+
+	static void _unregister(Local_& local) {
+		Global_& global = _global();
+		std::lock_guard<std::mutex> lock(global.localsMutex);
+		for (Local_** it = &global.locals; *it != nullptr; it = &(*it)->nextLocal) {
+			if (*it == &local) {
+				*it = local.nextLocal;
+				break;
+			}
+		}
+	}
+
+	static void _pushBatch(Batch_* batch) noexcept {
+		std::atomic<Batch_*>& batches = _global().batches;
+		batch->next = batches.load(std::memory_order_relaxed);
+		while (not batches.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+
+	/**
+	 * Makes sure the objects buffered by this thread are published, when it
+	 * exits, and that reclaim() finds them before that.
+	 */
+	static void _ensureFlusher(Local_& local) noexcept {
+		if (not local.hasFlusher) {
+			static thread_local LocalFlusher_ flusher;
+			(void)flusher;
+			local.hasFlusher = true;
+			Global_& global = _global();
+			std::lock_guard<std::mutex> lock(global.localsMutex);
+			local.nextLocal = global.locals;
+			global.locals = &local;
+		}
+	}
+};
+
+/**
+ *  @brief  Disposes all objects whose disposal has been deferred so far.
+ *  Returns their number.
+ */
+inline size_t reclaim() {
+	return DeferredDisposal::reclaim();
+}
+
+
+/**
+ * Calls reclaim() on a thread of its own every interval until it is
+ * destroyed. It reclaims one last time before it stops.
+ */
+class BackgroundReclaimer {
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	bool _isStopping = false;
+	std::thread _thread;
+
+public:
+	explicit BackgroundReclaimer(std::chrono::milliseconds interval = std::chrono::milliseconds(1))
+		: _thread([this, interval]() { _run(interval); })
+	{}
+
+	BackgroundReclaimer(const BackgroundReclaimer&) = delete;
+	BackgroundReclaimer& operator =(const BackgroundReclaimer&) = delete;
+
+	~BackgroundReclaimer() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isStopping = true;
+		}
+		_wakeUp.notify_one();
+		_thread.join();
+	}
+
+private:
+	void _run(std::chrono::milliseconds interval) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (not _wakeUp.wait_for(lock, interval, [this]() { return _isStopping; })) {
+			lock.unlock();
+			reclaim();
+			lock.lock();
+		}
+		lock.unlock();
+		reclaim();
+	}
+};
+
+}
+
+
+#endif // CAT_DEFERREDDISPOSAL_H
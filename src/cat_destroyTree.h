@@ -0,0 +1,230 @@
+#ifndef CAT_DESTROYTREE_H
+#define CAT_DESTROYTREE_H
+
+#include "cat_owningPtr.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace cat {
+
+/**
+ * Tells destroyTree() how to take the children out of a node. By default it
+ * calls
+ *   template <class Fn_> void detachChildren(Fn_&& fn);
+ * on the node, which has to pass every OwningPtr it owns to fn as an rvalue:
+ *   for (auto& child : _children) { fn(std::move(child)); }
+ * May be specialized for node types that can't get such a member.
+ */
+template <class T_>
+struct TreeChildren {
+	template <class Fn_>
+	static void detach(T_& node, Fn_&& fn) {
+		node.detachChildren(std::forward<Fn_>(fn));
+	}
+};
+
+
+/**
+ *  @brief  Destroys root and all its descendants with an explicit worklist
+ *  instead of recursion, so the depth of the tree does not matter.
+ *  Every node is destroyed after its children have been detached.
+ */
+template <class T_, class Deleter_>
+void destroyTree(OwningPtr<T_, Deleter_>&& root) {
+	using Ptr = OwningPtr<T_, Deleter_>;
+	if (root == nullptr) {
+		return;
+	}
+	std::vector<Ptr> worklist;
+	worklist.push_back(std::move(root));
+	while (not worklist.empty()) {
+		Ptr node = std::move(worklist.back());
+		worklist.pop_back();
+		TreeChildren<T_>::detach(*node, [&worklist](Ptr&& child) {
+			if (child != nullptr) {
+				worklist.push_back(std::move(child));
+			}
+		});
+	}
+}
+
+
+namespace _destroyTree_internal {
+
+/**
+ * The threads that help destroyTreeParallel(). They are started on first
+ * use and kept until the program exits. If a thread can't be started, the
+ * pool just stays smaller.
+ */
+class TeardownPool_ {
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	std::deque<std::function<void()>> _jobs;
+	std::vector<std::thread> _threads;
+	bool _isStopping = false;
+
+public:
+	static TeardownPool_& instance() {
+		static TeardownPool_ pool;
+		return pool;
+	}
+
+	TeardownPool_() = default;
+	TeardownPool_(const TeardownPool_&) = delete;
+	TeardownPool_& operator =(const TeardownPool_&) = delete;
+
+	~TeardownPool_() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isStopping = true;
+		}
+		_wakeUp.notify_all();
+		for (auto& thread : _threads) {
+			thread.join();
+		}
+	}
+
+	/**
+	 *  @brief  Starts threads until there are threadCnt of them, if possible.
+	 *  Returns the number of threads.
+	 */
+	size_t reserve(size_t threadCnt) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		while (_threads.size() < threadCnt) {
+			try {
+				_threads.emplace_back([this]() { _run(); });
+			} catch (const std::system_error&) {
+				break;
+			}
+		}
+		return _threads.size();
+	}
+
+	void post(std::function<void()> job) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_jobs.push_back(std::move(job));
+		}
+		_wakeUp.notify_one();
+	}
+
+private:
+	void _run() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true) {
+			_wakeUp.wait(lock, [this]() { return _isStopping or not _jobs.empty(); });
+			if (_jobs.empty()) {
+				return;
+			}
+			std::function<void()> job = std::move(_jobs.front());
+			_jobs.pop_front();
+			lock.unlock();
+			job();
+			lock.lock();
+		}
+	}
+};
+
+/**
+ * Lets the caller of destroyTreeParallel() wait for the helpers that have
+ * started. Helpers that start after the caller is done do nothing, so they
+ * never touch its (then gone) stack, and a destroyTreeParallel() on a pool
+ * thread never waits for jobs that are queued behind it.
+ */
+struct TeardownState_ {
+	std::mutex mutex;
+	std::condition_variable isIdle;
+	size_t activeCnt = 0;
+	bool isClosed = false;
+};
+
+}
+
+
+/**
+ *  @brief  Like destroyTree(), but destroys independent subtrees on up to
+ *  threadCnt threads (including the calling one, the others come from a
+ *  pool that is started on first use). The top of the tree is taken apart
+ *  breadth-first, until there are enough subtrees to share.
+ */
+template <class T_, class Deleter_>
+void destroyTreeParallel(OwningPtr<T_, Deleter_>&& root, size_t threadCnt = std::thread::hardware_concurrency()) {
+	using Ptr = OwningPtr<T_, Deleter_>;
+	constexpr size_t SUBTREES_PER_THREAD = 8;
+	if (threadCnt <= 1) {
+		destroyTree(std::move(root));
+		return;
+	}
+	if (root == nullptr) {
+		return;
+	}
+
+	std::vector<Ptr> subtrees;
+	subtrees.push_back(std::move(root));
+	size_t first = 0;
+	while (first < subtrees.size() && subtrees.size() - first < threadCnt * SUBTREES_PER_THREAD) {
+		Ptr node = std::move(subtrees[first++]);
+		TreeChildren<T_>::detach(*node, [&subtrees](Ptr&& child) {
+			if (child != nullptr) {
+				subtrees.push_back(std::move(child));
+			}
+		});
+	}
+
+	if (first == subtrees.size()) {
+		return; // the tree was small enough.
+	}
+
+	std::atomic<size_t> next = first;
+	auto work = [&subtrees, &next]() {
+		for (size_t i = next++; i < subtrees.size(); i = next++) {
+			destroyTree(std::move(subtrees[i]));
+		}
+	};
+	using namespace _destroyTree_internal;
+	TeardownPool_& pool = TeardownPool_::instance();
+	const size_t helperCnt = std::min(std::min(threadCnt, subtrees.size() - first) - 1, pool.reserve(threadCnt - 1));
+	const auto state = std::make_shared<TeardownState_>();
+	for (size_t t = 0; t < helperCnt; ++t) {
+		try {
+			pool.post([state, &work]() {
+				{
+					std::lock_guard<std::mutex> lock(state->mutex);
+					if (state->isClosed) {
+						return;
+					}
+					state->activeCnt += 1;
+				}
+				work();
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (--state->activeCnt == 0) {
+					state->isIdle.notify_all();
+				}
+			});
+		} catch (const std::bad_alloc&) {
+			break; // the calling thread does the rest.
+		}
+	}
+	work();
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->isClosed = true;
+	state->isIdle.wait(lock, [&state]() { return state->activeCnt == 0; });
+}
+
+}
+
+
+#endif // CAT_DESTROYTREE_H
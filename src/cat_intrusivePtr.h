@@ -0,0 +1,248 @@
+#ifndef CAT_INTRUSIVEPTR_H
+#define CAT_INTRUSIVEPTR_H
+
+#include "cat_weakPtr.h"
+#include "cat_sharedPtr.h"
+
+#include <cstddef>
+#include <utility>
+
+
+namespace cat {
+
+template <class T_>
+struct IntrusivePtr;
+
+/**
+ * CRTP base for objects that carry their own usage count:
+ *   struct Node: cat::IntrusiveRefCnt<Node> { ... };
+ * The counting policy is the same as for SharedPtr (see UnsyncedCounting and
+ * AtomicCounting).
+ *
+ * When the count drops to zero, the object is deleted as a Derived_. So if
+ * further classes derive from Derived_, Derived_ needs a virtual destructor.
+ * Copying an object does not copy its count.
+ */
+template <class Derived_, class Counting_ = UnsyncedCounting>
+struct IntrusiveRefCnt {
+public:
+	using Counting = Counting_;
+	using CntT = typename Counting::CntT;
+private:
+	mutable typename Counting::StorageT _usageCnt;
+
+	template<typename T2_>
+	friend struct IntrusivePtr;
+
+protected:
+	IntrusiveRefCnt() noexcept : _usageCnt(0) {}
+	IntrusiveRefCnt(const IntrusiveRefCnt&) noexcept : _usageCnt(0) {}
+	IntrusiveRefCnt& operator =(const IntrusiveRefCnt&) noexcept { return *this; }
+	~IntrusiveRefCnt() = default;
+
+public:
+	inline CntT getUsageCnt() const noexcept { return Counting::load(_usageCnt); }
+
+private:
+	inline void _incUsageCnt() const noexcept { Counting::increment(_usageCnt); }
+	inline void _decUsageCnt() const {
+		if (CAT_UNLIKELY(Counting::decrement(_usageCnt))) {
+			_dispose();
+		}
+	}
+
+	CAT_NOINLINE void _dispose() const {
+		delete static_cast<const Derived_*>(this);
+	}
+};
+
+
+/**
+ * IntrusivePtr is a SharedPtr for types that derive from IntrusiveRefCnt. It
+ * is only a single pointer wide and needs no separate control block.
+ *
+ * Because the count lives inside the target, an IntrusivePtr can be created
+ * from any raw pointer to an object that is already owned by IntrusivePtrs
+ * (e.g. from this). The target must have been allocated with new.
+ * Aggregates work too, as long as IntrusiveRefCnt is their first base.
+ */
+template <class T_>
+struct IntrusivePtr {
+public:
+	using T = T_;
+private:
+	T* _ptr;
+
+	template<typename T2_>
+	friend struct IntrusivePtr;
+
+public:
+	IntrusivePtr(const IntrusivePtr& other) noexcept
+		: _ptr(other._ptr)
+	{
+		_incRefCnt();
+	}
+
+	IntrusivePtr(IntrusivePtr&& other) noexcept
+		: _ptr(other._ptr)
+	{
+		other._ptr = nullptr;
+	}
+
+	template<class T2_, std::enable_if_t<std::is_base_of_v<T, T2_>, int> = 0>
+	IntrusivePtr(const IntrusivePtr<T2_>& other) noexcept
+		: _ptr(other._ptr)
+	{
+		_incRefCnt();
+	}
+
+	template<class T2_, std::enable_if_t<std::is_base_of_v<T, T2_>, int> = 0>
+	IntrusivePtr(IntrusivePtr<T2_>&& other) noexcept
+		: _ptr(other._ptr)
+	{
+		other._ptr = nullptr;
+	}
+
+	/**
+	 *  @brief  Shares ownership of ptr with all other IntrusivePtrs to it.
+	 */
+	explicit IntrusivePtr(T* ptr) noexcept
+		: _ptr(ptr)
+	{
+		_incRefCnt();
+	}
+
+	/**
+	 *  @brief  Creates a new T from args. If T is an aggregate, args
+	 *  initialize its members, and its IntrusiveRefCnt base (which must be
+	 *  the first one) is value-initialized:
+	 *    struct Pos: IntrusiveRefCnt<Pos> { int x, y; };
+	 *    IntrusivePtr<Pos> pos{{}, 3, 4};
+	 */
+	template <typename... Args>
+	explicit IntrusivePtr(InplaceConstructorTag, Args&& ...args)
+		: IntrusivePtr(_create(std::forward<Args>(args)...))
+	{}
+
+	template<class TNullptr, std::enable_if_t<std::is_same_v<TNullptr, std::nullptr_t>, int> = 0>
+	IntrusivePtr(TNullptr) noexcept : _ptr(nullptr) {}
+
+	~IntrusivePtr() {
+		_decRefCnt();
+	}
+
+public:
+	IntrusivePtr& operator=(const IntrusivePtr& other) {
+		IntrusivePtr tmp(other);
+		tmp.swap(*this);
+		return *this;
+	}
+
+	IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+		other.swap(*this);
+		return *this;
+	}
+
+public:
+	inline void swap(IntrusivePtr& other) noexcept {
+		std::swap(_ptr, other._ptr);
+	}
+
+	WeakPtr<T> getWeak() {
+		return WeakPtr<T>(_ptr);
+	}
+
+	WeakPtr<const T> getWeak() const {
+		return WeakPtr<const T>(_ptr);
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
+	 */
+	template<class T2_>
+	auto as() const -> WeakPtr<T2_> {
+		return WeakPtr<T2_>(kindCast<T2_>(_ptr));
+	}
+
+	/**
+	 *  @brief  Performs a static_cast<>().
+	 */
+	template<class T2_>
+	auto asStatic() const -> WeakPtr<T2_> {
+		return WeakPtr<T2_>(static_cast<T2_*>(_ptr));
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
+	 */
+	template<class T2_, std::enable_if_t<std::is_polymorphic_v<T> && std::is_polymorphic_v<T2_>, int> = 0>
+	IntrusivePtr<T2_> asIntrusive() const {
+		return IntrusivePtr<T2_>(kindCast<T2_>(_ptr));
+	}
+
+	/**
+	 *  @brief  Performs a static_cast<>().
+	 */
+	template<class T2_, std::enable_if_t<std::is_polymorphic_v<T> && std::is_polymorphic_v<T2_>, int> = 0>
+	IntrusivePtr<T2_> asIntrusiveStatic() const {
+		return IntrusivePtr<T2_>(static_cast<T2_*>(_ptr));
+	}
+
+	inline T& operator*() noexcept { return *_ptr; }
+	inline const T& operator*() const noexcept { return *_ptr; }
+
+	inline T* operator->() noexcept { return _ptr; }
+	inline const T* operator->() const noexcept { return _ptr; }
+
+	bool operator ==(const IntrusivePtr& other) const noexcept { return _ptr == other._ptr; }
+	bool operator ==(std::nullptr_t) const noexcept { return _ptr == nullptr; }
+
+	bool operator !=(const IntrusivePtr& other) const noexcept { return _ptr != other._ptr; }
+	bool operator !=(std::nullptr_t) const noexcept { return _ptr != nullptr; }
+
+	explicit operator bool () const noexcept { return _ptr != nullptr; }
+
+	inline T* ___getPtr() const noexcept {
+		return _ptr;
+	}
+
+private:
+	template <typename... Args>
+	static T* _create(Args&& ...args) {
+		using Target = std::remove_const_t<T>;
+		if constexpr (std::is_aggregate_v<Target>) {
+			// IntrusiveRefCnt's constructor is only accessible here, as its friend.
+			return new Target{{}, std::forward<Args>(args)...};
+		} else {
+			return new Target{std::forward<Args>(args)...};
+		}
+	}
+
+	inline void _incRefCnt() const noexcept {
+		if (_ptr != nullptr) {
+			_ptr->_incUsageCnt();
+		}
+	}
+
+	inline void _decRefCnt() {
+		if (_ptr != nullptr) {
+			_ptr->_decUsageCnt();
+		}
+	}
+};
+
+template <class T_>
+struct IsTriviallyRelocatable<IntrusivePtr<T_>>: std::true_type {};
+
+}
+
+
+template <class T_>
+struct std::hash<cat::IntrusivePtr<T_>> {
+	size_t operator()(const cat::IntrusivePtr<T_>& v) const noexcept {
+		return std::hash<T_*>()(v.___getPtr());
+	}
+};
+
+
+#endif // CAT_INTRUSIVEPTR_H
@@ -0,0 +1,76 @@
+#ifndef CAT_KINDCAST_H
+#define CAT_KINDCAST_H
+
+#include <cstdint>
+#include <type_traits>
+
+namespace cat {
+
+using Kind = uint32_t;
+
+/**
+ * The kinds of a class and all of its subclasses (inclusive). Subclasses get
+ * nested, disjoint ranges, e.g. by numbering the classes in depth-first order.
+ */
+struct KindRange {
+	Kind first;
+	Kind last;
+
+	constexpr bool isEmpty() const noexcept { return last < first; }
+
+	/**
+	 *  @brief  A single comparison, because kinds below first wrap around.
+	 */
+	constexpr bool contains(Kind kind) const noexcept { return kind - first <= last - first; }
+};
+
+template <class T_>
+struct KindTag final {};
+
+/**
+ * Fallback for CAT_KIND_RANGE(Cls, ...). The overloads declared by the macro
+ * are found through ADL. They take a KindTag instead of a pointer, so a
+ * subclass does not inherit the range of its base.
+ */
+template <class T_>
+constexpr KindRange ___catKindRange(KindTag<T_>) noexcept { return {1, 0}; }
+
+/**
+ * Declares the kinds of Cls and all of its subclasses. Use it in the
+ * namespace of Cls, e.g. right after PTRS_FOR_CLASS(Cls). Objects have to
+ * report their own kind through a public member function
+ *   cat::Kind getKind() const;
+ * which usually returns a field that is set by the constructors.
+ */
+#define CAT_KIND_RANGE(Cls, first, last) \
+	constexpr cat::KindRange ___catKindRange(cat::KindTag<Cls>) noexcept { return {first, last}; }
+
+template <class T_>
+inline constexpr KindRange kindRange_v = ___catKindRange(KindTag<std::remove_cv_t<T_>>{});
+
+template <class T_>
+inline constexpr bool hasKindRange_v = not kindRange_v<T_>.isEmpty();
+
+
+/**
+ *  @brief  Like dynamic_cast<T2_*>(ptr), but if both T_ and T2_ declared a
+ *  kind range and T2_ derives from T_, it only checks whether the kind of
+ *  *ptr is in the range of T2_. Such hierarchies need no RTTI and not even
+ *  virtual functions. T2_ must not be a virtual base.
+ */
+template <class T2_, class T_>
+inline T2_* kindCast(T_* ptr) {
+	if constexpr (hasKindRange_v<T_> && hasKindRange_v<T2_> && std::is_base_of_v<T_, T2_>) {
+		if (ptr != nullptr && kindRange_v<T2_>.contains(ptr->getKind())) {
+			return static_cast<T2_*>(ptr);
+		}
+		return nullptr;
+	} else {
+		return dynamic_cast<T2_*>(ptr);
+	}
+}
+
+}
+
+
+#endif // CAT_KINDCAST_H
@@ -0,0 +1,302 @@
+#ifndef CAT_OFFSETPTR_H
+#define CAT_OFFSETPTR_H
+
+#include "cat_weakPtr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace cat {
+
+namespace _offsetPtr_internal {
+
+/**
+ * The common part of all offset pointers: the distance in bytes from the
+ * pointer itself to its target. So a graph of offset pointers stays valid,
+ * when it is copied or mapped to another address as a whole.
+ * An offset of 0 is null, so an offset pointer can't point to itself.
+ */
+template <class T_>
+struct OffsetPtrBase_ {
+public:
+	using T = T_;
+
+protected:
+	std::ptrdiff_t _offset;
+
+	OffsetPtrBase_() noexcept : _offset(0) {}
+	explicit OffsetPtrBase_(T* ptr) noexcept { _set(ptr); }
+	~OffsetPtrBase_() = default;
+
+	inline void _set(T* ptr) noexcept {
+		_offset = ptr == nullptr ? 0 : static_cast<std::ptrdiff_t>(_address(ptr) - _address(this));
+	}
+
+public:
+	WeakPtr<T> getWeak() {
+		return WeakPtr<T>(___getPtr());
+	}
+
+	WeakPtr<const T> getWeak() const {
+		return WeakPtr<const T>(___getPtr());
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
+	 */
+	template<class T2_>
+	WeakPtr<T2_> as() const {
+		return WeakPtr<T2_>(kindCast<T2_>(___getPtr()));
+	}
+
+	/**
+	 *  @brief  Performs a static_cast<>().
+	 */
+	template<class T2_>
+	WeakPtr<T2_> asStatic() const {
+		return WeakPtr<T2_>(static_cast<T2_*>(___getPtr()));
+	}
+
+	inline T& operator *() noexcept { return *___getPtr(); }
+	inline const T& operator *() const noexcept { return *___getPtr(); }
+
+	inline T* operator ->() noexcept { return ___getPtr(); }
+	inline const T* operator ->() const noexcept { return ___getPtr(); }
+
+	inline bool operator ==(const OffsetPtrBase_& other) const noexcept { return ___getPtr() == other.___getPtr(); }
+	inline bool operator ==(std::nullptr_t) const noexcept { return _offset == 0; }
+
+	inline bool operator !=(const OffsetPtrBase_& other) const noexcept { return ___getPtr() != other.___getPtr(); }
+	inline bool operator !=(std::nullptr_t) const noexcept { return _offset != 0; }
+
+	explicit operator bool () const noexcept { return _offset != 0; }
+
+	inline T* ___getPtr() const noexcept {
+		if (_offset == 0) {
+			return nullptr;
+		}
+		return reinterpret_cast<T*>(_address(this) + _offset);
+	}
+
+private:
+	// integer arithmetic, because the target usually is not part of the same object as the pointer.
+	static inline std::uintptr_t _address(const volatile void* ptr) noexcept {
+		return reinterpret_cast<std::uintptr_t>(ptr);
+	}
+};
+
+}
+
+
+/**
+ * A WeakPtr that stores the offset to its target instead of its address. It
+ * may only point into the same block of memory that it lives in (e.g. a
+ * buffer of a RelocatableWriter), because that block is moved as a whole.
+ */
+template <class T_>
+struct OffsetWeakPtr: public _offsetPtr_internal::OffsetPtrBase_<T_> {
+private:
+	using Base = _offsetPtr_internal::OffsetPtrBase_<T_>;
+public:
+	using T = T_;
+
+	OffsetWeakPtr() noexcept : Base() {}
+	OffsetWeakPtr(std::nullptr_t) noexcept : Base() {}
+	OffsetWeakPtr(T* ptr) noexcept : Base(ptr) {}
+	OffsetWeakPtr(WeakPtr<T> ptr) noexcept : Base(ptr.___getPtr()) {}
+
+	// the offset has to be recalculated for the new address.
+	OffsetWeakPtr(const OffsetWeakPtr& other) noexcept : Base(other.___getPtr()) {}
+
+	OffsetWeakPtr& operator =(const OffsetWeakPtr& other) noexcept {
+		this->_set(other.___getPtr());
+		return *this;
+	}
+
+	OffsetWeakPtr& operator =(T* ptr) noexcept {
+		this->_set(ptr);
+		return *this;
+	}
+};
+
+
+/**
+ * Signifies ownership like OwningPtr, but stores the offset to its target.
+ * It doesn't free its target, the block of memory that holds both of them
+ * does (see RelocatableWriter). Targets must be trivially destructible.
+ */
+template <class T_>
+struct OffsetOwningPtr: public _offsetPtr_internal::OffsetPtrBase_<T_> {
+private:
+	using Base = _offsetPtr_internal::OffsetPtrBase_<T_>;
+public:
+	using T = T_;
+
+	OffsetOwningPtr() noexcept : Base() {}
+	OffsetOwningPtr(std::nullptr_t) noexcept : Base() {}
+	/**
+	 *  @brief  Takes over ptr, which must be in the same block of memory.
+	 */
+	explicit OffsetOwningPtr(T* ptr) noexcept : Base(ptr) {}
+
+	OffsetOwningPtr(const OffsetOwningPtr&) = delete;
+	OffsetOwningPtr(OffsetOwningPtr&& other) noexcept : Base(other.___getPtr()) {
+		other._set(nullptr);
+	}
+
+	OffsetOwningPtr& operator =(const OffsetOwningPtr&) = delete;
+	OffsetOwningPtr& operator =(OffsetOwningPtr&& other) noexcept {
+		T* ptr = other.___getPtr();
+		other._set(nullptr);
+		this->_set(ptr);
+		return *this;
+	}
+
+	/**
+	 *  @brief  Takes over ptr, which must be in the same block of memory.
+	 */
+	void reset(T* ptr = nullptr) noexcept {
+		this->_set(ptr);
+	}
+};
+
+
+/**
+ * size consecutive Ts, referenced by their offset like OffsetWeakPtr.
+ */
+template <class T_>
+struct OffsetArray {
+public:
+	using T = T_;
+
+private:
+	OffsetWeakPtr<T> _first;
+	size_t _size;
+
+public:
+	OffsetArray() noexcept : _first(), _size(0) {}
+	OffsetArray(T* first, size_t size) noexcept : _first(size != 0 ? first : nullptr), _size(size) {}
+
+	inline size_t size() const noexcept { return _size; }
+	inline bool empty() const noexcept { return _size == 0; }
+
+	inline T* begin() noexcept { return _first.___getPtr(); }
+	inline T* end() noexcept { return begin() + _size; }
+	inline const T* begin() const noexcept { return _first.___getPtr(); }
+	inline const T* end() const noexcept { return begin() + _size; }
+
+	inline T& operator [](size_t index) noexcept { return begin()[index]; }
+	inline const T& operator [](size_t index) const noexcept { return begin()[index]; }
+};
+
+
+/**
+ * The position of an object in the buffer of a RelocatableWriter. Unlike a
+ * pointer, it stays valid while the buffer grows.
+ */
+template <class T_>
+struct RelocatableRef {
+	size_t offset;
+};
+
+/**
+ * Lays out a graph of objects in one contiguous, position-independent
+ * buffer. The objects point to each other with OffsetOwningPtrs,
+ * OffsetWeakPtrs and OffsetArrays, so the buffer can be written to a file
+ * and later be mapped (or read) back to any address, suitably aligned, and
+ * used in place:
+ *   RelocatableWriter writer;
+ *   auto root = writer.create<Node>(...); // the first object is the root.
+ *   auto child = writer.create<Node>(...);
+ *   writer.get(root)->child.reset(writer.get(child));
+ *   writer.get(child)->parent = writer.get(root);
+ *   ...
+ *   const Node* loaded = relocatableRoot<Node>(data);
+ *
+ * The buffer grows by copying its bytes, so get() only returns a valid
+ * pointer until the next create() or createArray().
+ */
+class RelocatableWriter {
+public:
+	/**
+	 * The buffer is only guaranteed to be aligned to this.
+	 */
+	static constexpr size_t MAX_ALIGNMENT = alignof(std::max_align_t);
+
+private:
+	std::vector<std::byte> _buffer;
+
+public:
+	template <class T_, class... Args_>
+	RelocatableRef<T_> create(Args_&&... args) {
+		_checkType<T_>();
+		const size_t offset = _allocate(sizeof(T_), alignof(T_));
+		new (_buffer.data() + offset) T_{std::forward<Args_>(args)...};
+		return {offset};
+	}
+
+	/**
+	 *  @brief  Creates size value-initialized Ts, use get() + index to access them.
+	 */
+	template <class T_>
+	RelocatableRef<T_> createArray(size_t size) {
+		_checkType<T_>();
+		const size_t offset = _allocate(sizeof(T_) * size, alignof(T_));
+		for (size_t i = 0; i < size; ++i) {
+			new (_buffer.data() + offset + i * sizeof(T_)) T_();
+		}
+		return {offset};
+	}
+
+	/**
+	 *  @brief  Only valid until the next create() or createArray().
+	 */
+	template <class T_>
+	T_* get(RelocatableRef<T_> ref) noexcept {
+		return std::launder(reinterpret_cast<T_*>(_buffer.data() + ref.offset));
+	}
+
+	inline const std::byte* data() const noexcept { return _buffer.data(); }
+	inline size_t size() const noexcept { return _buffer.size(); }
+
+	std::vector<std::byte> release() noexcept {
+		return std::move(_buffer);
+	}
+
+private:
+	template <class T_>
+	static constexpr void _checkType() {
+		static_assert(alignof(T_) <= MAX_ALIGNMENT, "Over-aligned types can't be placed in a relocatable buffer.");
+		static_assert(std::is_trivially_destructible_v<T_>, "The buffer is freed without destroying its objects.");
+	}
+
+	size_t _allocate(size_t size, size_t alignment) {
+		const size_t offset = (_buffer.size() + alignment - 1) / alignment * alignment;
+		_buffer.resize(offset + size);
+		return offset;
+	}
+};
+
+/**
+ *  @brief  The first object that was created by the RelocatableWriter that
+ *  wrote data. data must be aligned to RelocatableWriter::MAX_ALIGNMENT.
+ */
+template <class T_>
+inline T_* relocatableRoot(void* data) noexcept {
+	return std::launder(static_cast<T_*>(data));
+}
+
+template <class T_>
+inline const T_* relocatableRoot(const void* data) noexcept {
+	return std::launder(static_cast<const T_*>(data));
+}
+
+}
+
+
+#endif // CAT_OFFSETPTR_H
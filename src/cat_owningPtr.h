@@ -3,38 +3,206 @@
 
 #include "cat_weakPtr.h"
 
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
 
 namespace cat {
 
+/**
+ * The default deleter of OwningPtr. Uses delete.
+ */
+struct DefaultDelete {
+	template <class T_>
+	void operator()(T_* ptr) const {
+		delete ptr;
+	}
+};
+
+/**
+ * A deleter for objects that were allocated from a std::pmr::memory_resource.
+ * It remembers the resource together with the size and alignment of the
+ * object that was originally allocated, so it still works after the
+ * OwningPtr was converted to a (polymorphic) base class.
+ * Both are stored in 32 bits, so objects must be smaller than 4 GiB.
+ */
+struct PmrDelete {
+private:
+	std::pmr::memory_resource* _resource = nullptr;
+	uint32_t _size = 0;
+	uint32_t _alignment = 0;
+
+public:
+	PmrDelete() noexcept = default;
+	PmrDelete(std::pmr::memory_resource* resource, size_t size, size_t alignment) noexcept
+		: _resource(resource),
+		  _size(static_cast<uint32_t>(size)),
+		  _alignment(static_cast<uint32_t>(alignment))
+	{}
+
+	inline std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+	template <class T_>
+	void operator()(T_* ptr) const {
+		void* storage;
+		if constexpr (std::is_polymorphic_v<T_>) {
+			storage = const_cast<void*>(dynamic_cast<const void*>(ptr));
+		} else {
+			storage = const_cast<std::remove_const_t<T_>*>(ptr);
+		}
+		std::destroy_at(ptr);
+		_resource->deallocate(storage, _size, _alignment);
+	}
+};
+
+
+/**
+ * Decides whether ArenaDelete may skip the destructor of T_. True for
+ * trivially destructible types. May be specialized for types that only own
+ * memory from the same arena (e.g. tree nodes with ArenaOwningPtr children),
+ * so a whole tree can be dropped together with its arena without visiting
+ * a single node.
+ */
+template <class T_>
+struct SkipArenaDestruction: std::is_trivially_destructible<T_> {};
 
 template <class T_>
-struct OwningPtr {
+inline constexpr bool skipArenaDestruction_v = SkipArenaDestruction<std::remove_const_t<T_>>::value;
+
+/**
+ * A deleter for objects that were allocated from an arena (a
+ * std::pmr::monotonic_buffer_resource). It only runs the destructor, the
+ * memory is freed all at once when the arena is released or destroyed.
+ * ArenaDelete is empty, so an ArenaOwningPtr is only one pointer wide.
+ */
+struct ArenaDelete {
+	template <class T_>
+	void operator()(T_* ptr) const {
+		if constexpr (not skipArenaDestruction_v<T_>) {
+			std::destroy_at(ptr);
+		}
+	}
+};
+
+
+/**
+ * Decides whether OwningPtr(InplaceConstructorTag, ...) lets the deleter
+ * allocate the target, by calling deleter.create<T>(args...). Specialized
+ * for deleters that need to allocate something together with the target,
+ * e.g. PromotableDelete.
+ */
+template <class Deleter_>
+struct DeleterCreatesTarget: std::false_type {};
+
+template <class Deleter_>
+inline constexpr bool deleterCreatesTarget_v = DeleterCreatesTarget<Deleter_>::value;
+
+/**
+ * Decides whether OwningPtr(T*) and reset(T*) are available, i.e. whether a
+ * default constructed deleter can dispose of a target that was allocated
+ * with new. False for deleters that need to know where the target came from
+ * (PmrDelete, ArenaDelete) or that create it themselves (see
+ * DeleterCreatesTarget). Such targets can only be adopted together with
+ * their deleter.
+ */
+template <class Deleter_>
+struct DeleterAcceptsRawPointer: std::bool_constant<not deleterCreatesTarget_v<Deleter_>> {};
+
+template <>
+struct DeleterAcceptsRawPointer<PmrDelete>: std::false_type {};
+
+template <>
+struct DeleterAcceptsRawPointer<ArenaDelete>: std::false_type {};
+
+template <class Deleter_>
+inline constexpr bool deleterAcceptsRawPointer_v = DeleterAcceptsRawPointer<Deleter_>::value;
+
+
+/**
+ * The deleter is stored as an (empty) base, so an OwningPtr with the
+ * DefaultDelete is still only one pointer wide.
+ */
+template <class T_, class Deleter_ = DefaultDelete>
+struct OwningPtr: private Deleter_ {
 public:
 	using T = T_;
+	using Deleter = Deleter_;
 
 private:
 	T* _ptr;
 
-    template<typename T2_>
+    template<typename T2_, class Deleter2_>
     friend struct OwningPtr;
 
 public:
 	OwningPtr() noexcept : _ptr(nullptr) {}
+	OwningPtr(std::nullptr_t) noexcept : _ptr(nullptr) {}
+
+	/**
+	 *  @brief  Only available, if a default constructed deleter can dispose
+	 *  of ptr (see DeleterAcceptsRawPointer).
+	 */
+	template<class Deleter2_ = Deleter, std::enable_if_t<deleterAcceptsRawPointer_v<Deleter2_>, int> = 0>
 	OwningPtr(T* ptr) noexcept : _ptr(ptr) {}
 
+	/**
+	 *  @brief  deleter must be able to dispose of ptr. e.g. it comes from
+	 *  the OwningPtr that owned ptr before.
+	 */
+	OwningPtr(T* ptr, Deleter deleter) noexcept : Deleter(std::move(deleter)), _ptr(ptr) {}
+
 	template<class... Args_>
 	OwningPtr(InplaceConstructorTag, Args_&&... __args){
-		_ptr = new T{std::forward<Args_>(__args)...};
+		static_assert(std::is_same_v<Deleter, DefaultDelete> || deleterCreatesTarget_v<Deleter>, "This deleter can't dispose of a target allocated with new. Use the memory_resource constructor for a PmrOwningPtr, the arena constructor for an ArenaOwningPtr.");
+		if constexpr (deleterCreatesTarget_v<Deleter>) {
+			_ptr = getDeleter().template create<T>(std::forward<Args_>(__args)...);
+		} else {
+			_ptr = new T{std::forward<Args_>(__args)...};
+		}
+	}
+
+	/**
+	 *  @brief  Allocates a new T from resource. Only available for PmrOwningPtr.
+	 */
+	template<class... Args_>
+	OwningPtr(std::pmr::memory_resource* resource, InplaceConstructorTag, Args_&&... __args)
+		: Deleter(resource, sizeof(T), alignof(T)),
+		  _ptr(nullptr)
+	{
+		static_assert(std::is_same_v<Deleter, PmrDelete>, "Only a PmrOwningPtr can be allocated from a memory_resource.");
+		static_assert(sizeof(T) <= UINT32_MAX, "PmrDelete can't store the size of objects of 4 GiB or more.");
+		void* storage = resource->allocate(sizeof(T), alignof(T));
+		try {
+			_ptr = new (storage) std::remove_const_t<T>{std::forward<Args_>(__args)...};
+		} catch (...) {
+			resource->deallocate(storage, sizeof(T), alignof(T));
+			throw;
+		}
+	}
+
+	/**
+	 *  @brief  Allocates a new T from arena. Only available for ArenaOwningPtr.
+	 *  The arena must outlive the returned pointer.
+	 */
+	template<class... Args_>
+	OwningPtr(std::pmr::monotonic_buffer_resource& arena, InplaceConstructorTag, Args_&&... __args)
+		: _ptr(nullptr)
+	{
+		static_assert(std::is_same_v<Deleter, ArenaDelete>, "Only an ArenaOwningPtr can be allocated from an arena.");
+		void* storage = arena.allocate(sizeof(T), alignof(T));
+		_ptr = new (storage) std::remove_const_t<T>{std::forward<Args_>(__args)...};
 	}
 
 	OwningPtr(const OwningPtr& other) = delete;
-	OwningPtr(OwningPtr&& other) noexcept : _ptr(std::move(other._ptr)) {
+	OwningPtr(OwningPtr&& other) noexcept : Deleter(std::move(other.getDeleter())), _ptr(other._ptr) {
 		other._ptr = nullptr;
 	}
 
 	template<class T2_, std::enable_if_t<std::is_base_of_v<T, T2_>, int> = 0>
-    OwningPtr(OwningPtr<T2_>&& other) noexcept : _ptr(std::move(other._ptr)) {
-        other._ptr = nullptr;
+	OwningPtr(OwningPtr<T2_, Deleter>&& other) noexcept : Deleter(std::move(other.getDeleter())), _ptr(other._ptr) {
+		other._ptr = nullptr;
 	}
 
 	~OwningPtr() {
@@ -43,10 +211,20 @@ public:
 
 public:
 	OwningPtr& operator =(const OwningPtr& other) = delete;
-	OwningPtr& operator =(OwningPtr&& other) {
-		// maybe use a std::swap of _ptrs instead of calling reset?
-		reset(other._ptr);
-		other._ptr = nullptr;
+	/**
+	 *  @brief  Like std::unique_ptr: other is released before the old target
+	 *  is destroyed, so a self-move keeps the target.
+	 */
+	OwningPtr& operator =(OwningPtr&& other) noexcept {
+		_reset(other.release());
+		getDeleter() = std::move(other.getDeleter());
+		return *this;
+	}
+
+	template<class T2_, std::enable_if_t<std::is_base_of_v<T, T2_>, int> = 0>
+	OwningPtr& operator =(OwningPtr<T2_, Deleter>&& other) noexcept {
+		_reset(other.release());
+		getDeleter() = std::move(other.getDeleter());
 		return *this;
 	}
 
@@ -60,11 +238,11 @@ public:
 	}
 
 	/**
-	 *  @brief  Performs a dynamic_cast<>().
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
 	 */
 	template<class T2_>
 	WeakPtr<T2_> as() const {
-		return WeakPtr(dynamic_cast<T2_*>(_ptr));
+		return WeakPtr(kindCast<T2_>(_ptr));
 	}
 
 	/**
@@ -79,12 +257,12 @@ public:
 	/**
 	 *  @brief  Performs a dynamic_cast<>().
 	 */
-	template<class T2_, std::enable_if_t<std::is_polymorphic_v<T> && std::is_polymorphic_v<T2_>, int> = 0>
-	OwningPtr<T2_> asOwning() { // maybe noexcept?
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	OwningPtr<T2_, Deleter> asOwning() { // maybe noexcept?
 		// what if _ptr is nullptr?
 		if (auto result = as<T2_>()) {
 			_ptr = nullptr;
-			return {result.___getPtr()};
+			return {result.___getPtr(), std::move(getDeleter())};
 		} else {
 			return nullptr;
 		}
@@ -94,11 +272,11 @@ public:
 	/**
 	 *  @brief  Performs a static_cast<>().
 	 */
-	template<class T2_, std::enable_if_t<std::is_polymorphic_v<T> && std::is_polymorphic_v<T2_>, int> = 0>
-	OwningPtr<T2_> asOwningStatic() { // maybe noexcept?
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	OwningPtr<T2_, Deleter> asOwningStatic() { // maybe noexcept?
 		auto result = asStatic<T2_>();
 		_ptr = nullptr;
-		return {result.___getPtr()};
+		return {result.___getPtr(), std::move(getDeleter())};
 	}
 
 	inline T& operator *() noexcept { return *_ptr; }
@@ -122,21 +300,73 @@ public:
     inline T* ___getPtr() const noexcept {
 		return _ptr;
 	}
+
+	/**
+	 *  @brief  Gives up the ownership of the target without destroying it.
+	 *  The caller has to dispose of it with getDeleter().
+	 */
+	inline T* release() noexcept {
+		T* ptr = _ptr;
+		_ptr = nullptr;
+		return ptr;
+	}
+
+	inline Deleter& getDeleter() noexcept { return *this; }
+	inline const Deleter& getDeleter() const noexcept { return *this; }
+
 protected:
-   inline void reset(T* newPtr = nullptr) {
-		if (_ptr != nullptr) {
-			delete _ptr;
-		}
+	inline void reset() noexcept {
+		_reset(nullptr);
+	}
+
+	/**
+	 *  @brief  Only available, if a default constructed deleter can dispose
+	 *  of newPtr (see DeleterAcceptsRawPointer).
+	 */
+	template<class Deleter2_ = Deleter, std::enable_if_t<deleterAcceptsRawPointer_v<Deleter2_>, int> = 0>
+	inline void reset(T* newPtr) noexcept {
+		_reset(newPtr);
+	}
+
+private:
+	/**
+	 *  @brief  Sets _ptr before the old target is destroyed, like
+	 *  std::unique_ptr::reset(), so the destructor of the old target never
+	 *  sees a dangling pointer in this OwningPtr.
+	 */
+	inline void _reset(T* newPtr) noexcept {
+		T* oldPtr = _ptr;
 		_ptr = newPtr;
+		if (oldPtr != nullptr) {
+			getDeleter()(oldPtr);
+		}
 	}
 
 };
 
-}
+/**
+ * An OwningPtr whose target was allocated from a std::pmr::memory_resource:
+ *   PmrOwningPtr<Circle> circle{&pool, {}, 7.5, Position(...)};
+ */
+template <class T_>
+using PmrOwningPtr = OwningPtr<T_, PmrDelete>;
 
+/**
+ * An OwningPtr whose target was allocated from an arena:
+ *   std::pmr::monotonic_buffer_resource arena;
+ *   ArenaOwningPtr<Circle> circle{arena, {}, 7.5, Position(...)};
+ */
 template <class T_>
-struct std::hash<cat::OwningPtr<T_>> {
-	size_t operator()(const cat::OwningPtr<T_>& v) const noexcept {
+using ArenaOwningPtr = OwningPtr<T_, ArenaDelete>;
+
+template <class T_, class Deleter_>
+struct IsTriviallyRelocatable<OwningPtr<T_, Deleter_>>: IsTriviallyRelocatable<Deleter_> {};
+
+}
+
+template <class T_, class Deleter_>
+struct std::hash<cat::OwningPtr<T_, Deleter_>> {
+	size_t operator()(const cat::OwningPtr<T_, Deleter_>& v) const noexcept {
 		return std::hash<T_*>()(v.___getPtr());
 	}
 };
@@ -0,0 +1,431 @@
+#ifndef CAT_PERSISTENT_H
+#define CAT_PERSISTENT_H
+
+#include "cat_cowPtr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+
+namespace cat {
+
+namespace _persistent_internal {
+
+constexpr size_t BITS = 5;
+constexpr size_t WIDTH = size_t(1) << BITS;
+constexpr size_t MASK = WIDTH - 1;
+
+inline int popCount(uint32_t bits) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcount(bits);
+#else
+	int cnt = 0;
+	for (; bits != 0; bits &= bits - 1) {
+		++cnt;
+	}
+	return cnt;
+#endif
+}
+
+}
+
+
+/**
+ * An immutable-by-default vector, that shares its nodes with its copies. It
+ * is a 32-way trie of CowPtr nodes, so copying it (e.g. taking a snapshot)
+ * is O(1) and changing it is O(log32 n).
+ *
+ * The with...() functions return a new version and leave this one
+ * unchanged. The mutating functions are the transient mode: they modify the
+ * nodes that are not shared with another version in place, and only copy
+ * the shared ones. e.g.:
+ *   PersistentVector<int> v;
+ *   for (...) { v.pushBack(i); } // no copies, v is not shared.
+ *   PersistentVector<int> snapshot = v; // O(1).
+ *   v.set(0, 42); // copies one path of nodes, snapshot is unchanged.
+ */
+template <class T_, class Counting_ = UnsyncedCounting>
+class PersistentVector {
+public:
+	using T = T_;
+	using Counting = Counting_;
+
+private:
+	struct Node_;
+	using NodePtr = CowPtr<Node_, Counting>;
+
+	/**
+	 * Inner nodes only have children, leaves only have values.
+	 */
+	struct Node_ {
+		std::vector<NodePtr> children;
+		std::vector<T> values;
+	};
+
+	static constexpr size_t BITS = _persistent_internal::BITS;
+	static constexpr size_t MASK = _persistent_internal::MASK;
+
+	NodePtr _root = nullptr;
+	size_t _size = 0;
+	size_t _shift = 0; // 0, if the root is a leaf.
+
+public:
+	PersistentVector() noexcept = default;
+
+	inline size_t size() const noexcept { return _size; }
+	inline bool empty() const noexcept { return _size == 0; }
+
+	const T& operator [](size_t index) const noexcept {
+		const Node_* node = _root.___getPtr();
+		for (size_t shift = _shift; shift > 0; shift -= BITS) {
+			node = node->children[(index >> shift) & MASK].___getPtr();
+		}
+		return node->values[index & MASK];
+	}
+
+	inline const T& back() const noexcept { return (*this)[_size - 1]; }
+
+	/**
+	 *  @brief  Calls fn(const T&) for every element in order.
+	 */
+	template <class Fn_>
+	void forEach(Fn_&& fn) const {
+		if (_root != nullptr) {
+			_forEach(*_root, fn);
+		}
+	}
+
+	void set(size_t index, T value) {
+		Node_* node = &_root.getMutable();
+		for (size_t shift = _shift; shift > 0; shift -= BITS) {
+			node = &node->children[(index >> shift) & MASK].getMutable();
+		}
+		node->values[index & MASK] = std::move(value);
+	}
+
+	void pushBack(T value) {
+		if (_root == nullptr) {
+			_root = NodePtr(InplaceConstructorTag{});
+		} else if (_size == size_t(1) << (_shift + BITS)) {
+			NodePtr newRoot{InplaceConstructorTag{}};
+			newRoot.getMutable().children.push_back(std::move(_root));
+			_root = std::move(newRoot);
+			_shift += BITS;
+		}
+		Node_* node = &_root.getMutable();
+		for (size_t shift = _shift; shift > 0; shift -= BITS) {
+			const size_t childIndex = (_size >> shift) & MASK;
+			if (childIndex == node->children.size()) {
+				node->children.emplace_back(InplaceConstructorTag{});
+			}
+			node = &node->children[childIndex].getMutable();
+		}
+		node->values.push_back(std::move(value));
+		++_size;
+	}
+
+	void popBack() {
+		_popBack(_root, _shift);
+		--_size;
+		if (_size == 0) {
+			_root = nullptr;
+			_shift = 0;
+			return;
+		}
+		while (_shift > 0 and _root->children.size() == 1) {
+			_root = NodePtr(_root->children.front());
+			_shift -= BITS;
+		}
+	}
+
+	void clear() noexcept {
+		_root = nullptr;
+		_size = 0;
+		_shift = 0;
+	}
+
+	PersistentVector withSet(size_t index, T value) const {
+		PersistentVector result = *this;
+		result.set(index, std::move(value));
+		return result;
+	}
+
+	PersistentVector withPushBack(T value) const {
+		PersistentVector result = *this;
+		result.pushBack(std::move(value));
+		return result;
+	}
+
+	PersistentVector withPopBack() const {
+		PersistentVector result = *this;
+		result.popBack();
+		return result;
+	}
+
+private:
+	template <class Fn_>
+	static void _forEach(const Node_& node, Fn_& fn) {
+		for (const T& value : node.values) {
+			fn(value);
+		}
+		for (const NodePtr& child : node.children) {
+			_forEach(*child, fn);
+		}
+	}
+
+	static void _popBack(NodePtr& nodePtr, size_t shift) {
+		Node_& node = nodePtr.getMutable();
+		if (shift == 0) {
+			node.values.pop_back();
+			return;
+		}
+		NodePtr& child = node.children.back();
+		_popBack(child, shift - BITS);
+		if (child->children.empty() and child->values.empty()) {
+			node.children.pop_back();
+		}
+	}
+};
+
+
+/**
+ * An immutable-by-default hash map, that shares its nodes with its copies.
+ * It is a hash array mapped trie (HAMT) of CowPtr nodes: every node uses 5
+ * bits of the hash to pick one of 32 slots, but only stores the used ones.
+ * Keys whose hashes are fully equal end up in a collision node.
+ *
+ * Like PersistentVector, the with...() functions return a new version and
+ * the mutating functions are the transient mode.
+ */
+template <class K_, class V_, class Hash_ = std::hash<K_>, class Eq_ = std::equal_to<K_>, class Counting_ = UnsyncedCounting>
+class PersistentMap {
+public:
+	using Key = K_;
+	using Value = V_;
+	using Counting = Counting_;
+
+private:
+	struct Node_;
+	using NodePtr = CowPtr<Node_, Counting>;
+
+	struct Entry_ {
+		size_t hash;
+		Key key;
+		Value value;
+	};
+
+	using Item_ = std::variant<Entry_, NodePtr>;
+
+	/**
+	 * The items are ordered by their index in the bitmap. The bitmap of a
+	 * collision node is unused.
+	 */
+	struct Node_ {
+		uint32_t bitmap = 0;
+		std::vector<Item_> items;
+	};
+
+	static constexpr size_t BITS = _persistent_internal::BITS;
+	static constexpr size_t MASK = _persistent_internal::MASK;
+	static constexpr size_t HASH_BITS = sizeof(size_t) * 8;
+
+	NodePtr _root = nullptr;
+	size_t _size = 0;
+
+public:
+	PersistentMap() noexcept = default;
+
+	inline size_t size() const noexcept { return _size; }
+	inline bool empty() const noexcept { return _size == 0; }
+
+	/**
+	 *  @brief  nullptr, if there is no value for key.
+	 */
+	const Value* find(const Key& key) const {
+		const size_t hash = Hash_()(key);
+		const Node_* node = _root.___getPtr();
+		for (size_t shift = 0; node != nullptr; shift += BITS) {
+			if (shift >= HASH_BITS) {
+				const Entry_* entry = _findCollision(*node, key);
+				return entry != nullptr ? &entry->value : nullptr;
+			}
+			const uint32_t bit = _bit(hash, shift);
+			if ((node->bitmap & bit) == 0) {
+				return nullptr;
+			}
+			const Item_& item = node->items[_position(*node, bit)];
+			if (const Entry_* entry = std::get_if<Entry_>(&item)) {
+				return entry->hash == hash && Eq_()(entry->key, key) ? &entry->value : nullptr;
+			}
+			node = std::get<NodePtr>(item).___getPtr();
+		}
+		return nullptr;
+	}
+
+	inline bool contains(const Key& key) const { return find(key) != nullptr; }
+
+	/**
+	 *  @brief  Calls fn(const Key&, const Value&) for every entry in no particular order.
+	 */
+	template <class Fn_>
+	void forEach(Fn_&& fn) const {
+		if (_root != nullptr) {
+			_forEach(*_root, fn);
+		}
+	}
+
+	/**
+	 *  @brief  Inserts or replaces the value for key.
+	 */
+	void set(Key key, Value value) {
+		if (_root == nullptr) {
+			_root = NodePtr(InplaceConstructorTag{});
+		}
+		const size_t hash = Hash_()(key);
+		if (_set(_root, 0, Entry_{hash, std::move(key), std::move(value)})) {
+			++_size;
+		}
+	}
+
+	/**
+	 *  @brief  Returns false, if there was no value for key.
+	 */
+	bool erase(const Key& key) {
+		if (not contains(key)) {
+			return false; // don't copy any shared nodes.
+		}
+		_erase(_root, Hash_()(key), 0, key);
+		if (--_size == 0) {
+			_root = nullptr;
+		}
+		return true;
+	}
+
+	void clear() noexcept {
+		_root = nullptr;
+		_size = 0;
+	}
+
+	PersistentMap withSet(Key key, Value value) const {
+		PersistentMap result = *this;
+		result.set(std::move(key), std::move(value));
+		return result;
+	}
+
+	PersistentMap withErase(const Key& key) const {
+		PersistentMap result = *this;
+		result.erase(key);
+		return result;
+	}
+
+private:
+	static inline uint32_t _bit(size_t hash, size_t shift) noexcept {
+		return uint32_t(1) << ((hash >> shift) & MASK);
+	}
+
+	static inline size_t _position(const Node_& node, uint32_t bit) noexcept {
+		return size_t(_persistent_internal::popCount(node.bitmap & (bit - 1)));
+	}
+
+	static const Entry_* _findCollision(const Node_& node, const Key& key) {
+		for (const Item_& item : node.items) {
+			const Entry_& entry = std::get<Entry_>(item);
+			if (Eq_()(entry.key, key)) {
+				return &entry;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 *  @brief  Returns true, if the key was new.
+	 */
+	static bool _set(NodePtr& nodePtr, size_t shift, Entry_&& newEntry) {
+		Node_& node = nodePtr.getMutable();
+		if (shift >= HASH_BITS) {
+			for (Item_& item : node.items) {
+				Entry_& entry = std::get<Entry_>(item);
+				if (Eq_()(entry.key, newEntry.key)) {
+					entry.value = std::move(newEntry.value);
+					return false;
+				}
+			}
+			node.items.emplace_back(std::move(newEntry));
+			return true;
+		}
+		const uint32_t bit = _bit(newEntry.hash, shift);
+		const size_t position = _position(node, bit);
+		if ((node.bitmap & bit) == 0) {
+			node.items.emplace(node.items.begin() + std::ptrdiff_t(position), std::move(newEntry));
+			node.bitmap |= bit;
+			return true;
+		}
+		Item_& item = node.items[position];
+		if (Entry_* entry = std::get_if<Entry_>(&item)) {
+			if (entry->hash == newEntry.hash && Eq_()(entry->key, newEntry.key)) {
+				entry->value = std::move(newEntry.value);
+				return false;
+			}
+			NodePtr child{InplaceConstructorTag{}};
+			_set(child, shift + BITS, std::move(*entry));
+			_set(child, shift + BITS, std::move(newEntry));
+			item = std::move(child);
+			return true;
+		}
+		return _set(std::get<NodePtr>(item), shift + BITS, std::move(newEntry));
+	}
+
+	/**
+	 *  @brief  key must be in the subtree of nodePtr.
+	 */
+	static void _erase(NodePtr& nodePtr, size_t hash, size_t shift, const Key& key) {
+		Node_& node = nodePtr.getMutable();
+		if (shift >= HASH_BITS) {
+			for (auto it = node.items.begin(); it != node.items.end(); ++it) {
+				if (Eq_()(std::get<Entry_>(*it).key, key)) {
+					node.items.erase(it);
+					return;
+				}
+			}
+			return;
+		}
+		const uint32_t bit = _bit(hash, shift);
+		const size_t position = _position(node, bit);
+		Item_& item = node.items[position];
+		if (std::holds_alternative<Entry_>(item)) {
+			node.items.erase(node.items.begin() + std::ptrdiff_t(position));
+			node.bitmap &= ~bit;
+			return;
+		}
+		NodePtr& child = std::get<NodePtr>(item);
+		_erase(child, hash, shift + BITS, key);
+		if (child->items.empty()) {
+			node.items.erase(node.items.begin() + std::ptrdiff_t(position));
+			node.bitmap &= ~bit;
+		} else if (child->items.size() == 1 and std::holds_alternative<Entry_>(child->items.front())) {
+			// pull a single entry up, so lookups stay short.
+			Entry_ entry = std::get<Entry_>(child->items.front());
+			item = std::move(entry);
+		}
+	}
+
+	template <class Fn_>
+	static void _forEach(const Node_& node, Fn_& fn) {
+		for (const Item_& item : node.items) {
+			if (const Entry_* entry = std::get_if<Entry_>(&item)) {
+				fn(entry->key, entry->value);
+			} else {
+				_forEach(*std::get<NodePtr>(item), fn);
+			}
+		}
+	}
+};
+
+}
+
+
+#endif // CAT_PERSISTENT_H
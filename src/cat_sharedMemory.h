@@ -0,0 +1,482 @@
+#ifndef CAT_SHAREDMEMORY_H
+#define CAT_SHAREDMEMORY_H
+
+#include "cat_sharedPtr.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace cat {
+
+/**
+ * A POSIX shared memory object (shm_open() + mmap()) together with a small
+ * allocator that lives inside of it, so that every process that maps the
+ * segment can allocate and free memory in it. The segment may be mapped to a
+ * different address in each process, so everything inside of it has to
+ * refer to each other by offsets (see cat_offsetPtr.h).
+ *
+ * The allocator is guarded by a spin lock in the segment. A process that
+ * dies while holding it leaves the segment locked.
+ */
+class SharedMemorySegment {
+public:
+	/**
+	 * Allocations are only guaranteed to be aligned to this.
+	 */
+	static constexpr size_t MAX_ALIGNMENT = 16;
+
+private:
+	static constexpr uint64_t MAGIC = 0x6361745368614D65; // "catShaMe"
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "The lock must be address-free to work across processes.");
+
+	struct alignas(64) Header_ {
+		uint64_t magic;
+		uint64_t size;
+		std::atomic<uint32_t> lock;
+		uint64_t top;      // the first offset that was never allocated.
+		uint64_t freeList; // the offset of the first free block, 0 if there is none. Sorted by offset.
+		uint64_t usedBytes;
+	};
+
+	struct alignas(MAX_ALIGNMENT) Block_ {
+		uint64_t size; // including this header.
+		uint64_t nextFree;
+	};
+
+	static constexpr size_t MIN_SPLIT_SIZE = sizeof(Block_) * 4;
+
+	Header_* _header = nullptr;
+	size_t _mappedSize = 0;
+
+	SharedMemorySegment(void* address, size_t size) noexcept
+		: _header(static_cast<Header_*>(address)), _mappedSize(size)
+	{}
+
+public:
+	SharedMemorySegment() noexcept = default;
+
+	SharedMemorySegment(const SharedMemorySegment&) = delete;
+	SharedMemorySegment(SharedMemorySegment&& other) noexcept
+		: _header(std::exchange(other._header, nullptr)), _mappedSize(std::exchange(other._mappedSize, 0))
+	{}
+
+	SharedMemorySegment& operator =(const SharedMemorySegment&) = delete;
+	SharedMemorySegment& operator =(SharedMemorySegment&& other) noexcept {
+		SharedMemorySegment tmp(std::move(other));
+		std::swap(_header, tmp._header);
+		std::swap(_mappedSize, tmp._mappedSize);
+		return *this;
+	}
+
+	/**
+	 *  @brief  Unmaps the segment. It (and everything in it) persists until it
+	 *  is unlink()ed and unmapped by all processes.
+	 */
+	~SharedMemorySegment() {
+		if (_header != nullptr) {
+			::munmap(_header, _mappedSize);
+		}
+	}
+
+	/**
+	 *  @brief  Creates and maps a new segment. name must start with a '/'.
+	 *  Throws a std::system_error, if it already exists.
+	 */
+	static SharedMemorySegment create(const char* name, size_t size) {
+		size = _roundUp(std::max(size, sizeof(Header_) + MIN_SPLIT_SIZE), alignof(Header_));
+		const int fd = ::shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+		if (fd == -1) {
+			throw std::system_error(errno, std::generic_category(), "shm_open");
+		}
+		if (::ftruncate(fd, off_t(size)) == -1) {
+			const int error = errno;
+			::close(fd);
+			::shm_unlink(name);
+			throw std::system_error(error, std::generic_category(), "ftruncate");
+		}
+		SharedMemorySegment segment(_map(fd, size), size);
+		Header_* header = new (segment._header) Header_();
+		header->size = size;
+		header->top = sizeof(Header_);
+		std::atomic_thread_fence(std::memory_order_release);
+		header->magic = MAGIC;
+		return segment;
+	}
+
+	/**
+	 *  @brief  Maps an existing segment, that was created by create().
+	 */
+	static SharedMemorySegment open(const char* name) {
+		const int fd = ::shm_open(name, O_RDWR, 0600);
+		if (fd == -1) {
+			throw std::system_error(errno, std::generic_category(), "shm_open");
+		}
+		struct stat st;
+		if (::fstat(fd, &st) == -1) {
+			const int error = errno;
+			::close(fd);
+			throw std::system_error(error, std::generic_category(), "fstat");
+		}
+		const size_t size = size_t(st.st_size);
+		SharedMemorySegment segment(_map(fd, size), size);
+		if (size < sizeof(Header_) or segment._header->magic != MAGIC or segment._header->size != size) {
+			throw std::system_error(EINVAL, std::generic_category(), "not a cat::SharedMemorySegment");
+		}
+		return segment;
+	}
+
+	/**
+	 *  @brief  Removes the name. The memory is freed, when the last process unmaps it.
+	 */
+	static void unlink(const char* name) noexcept {
+		::shm_unlink(name);
+	}
+
+	/**
+	 *  @brief  Throws std::bad_alloc, if there is no free block that is large enough.
+	 */
+	void* allocate(size_t size, size_t alignment = MAX_ALIGNMENT) {
+		if (alignment > MAX_ALIGNMENT) {
+			throw std::bad_alloc();
+		}
+		const uint64_t needed = sizeof(Block_) + _roundUp(std::max<size_t>(size, 1), MAX_ALIGNMENT);
+		_lock();
+		uint64_t* link = &_header->freeList;
+		while (*link != 0) {
+			Block_* block = _blockAt(*link);
+			if (block->size >= needed) {
+				const uint64_t offset = *link;
+				if (block->size - needed >= MIN_SPLIT_SIZE) {
+					Block_* rest = _blockAt(offset + needed);
+					rest->size = block->size - needed;
+					rest->nextFree = block->nextFree;
+					block->size = needed;
+					*link = offset + needed;
+				} else {
+					*link = block->nextFree;
+				}
+				_header->usedBytes += block->size;
+				_unlock();
+				return block + 1;
+			}
+			link = &block->nextFree;
+		}
+		if (_header->size - _header->top < needed) {
+			_unlock();
+			throw std::bad_alloc();
+		}
+		Block_* block = _blockAt(_header->top);
+		block->size = needed;
+		_header->top += needed;
+		_header->usedBytes += needed;
+		_unlock();
+		return block + 1;
+	}
+
+	/**
+	 *  @brief  Merges the block with its free neighbours, so they can be
+	 *  reused for larger allocations.
+	 */
+	void deallocate(void* ptr) noexcept {
+		if (ptr == nullptr) {
+			return;
+		}
+		Block_* block = static_cast<Block_*>(ptr) - 1;
+		uint64_t offset = offsetOf(block);
+		_lock();
+		_header->usedBytes -= block->size;
+		// insert it between the free blocks before and after it:
+		uint64_t* prevLink = nullptr;
+		uint64_t* link = &_header->freeList;
+		while (*link != 0 and *link < offset) {
+			prevLink = link;
+			link = &_blockAt(*link)->nextFree;
+		}
+		if (*link != 0 and offset + block->size == *link) {
+			const Block_* next = _blockAt(*link);
+			block->size += next->size;
+			block->nextFree = next->nextFree;
+		} else {
+			block->nextFree = *link;
+		}
+		*link = offset;
+		if (prevLink != nullptr and *prevLink + _blockAt(*prevLink)->size == offset) {
+			Block_* prev = _blockAt(*prevLink);
+			prev->size += block->size;
+			prev->nextFree = block->nextFree;
+			block = prev;
+			offset = *prevLink;
+			link = prevLink;
+		}
+		if (offset + block->size == _header->top) {
+			// the last free block, give it back to the never allocated space.
+			*link = block->nextFree;
+			_header->top = offset;
+		}
+		_unlock();
+	}
+
+	inline bool isMapped() const noexcept { return _header != nullptr; }
+	inline size_t size() const noexcept { return _mappedSize; }
+
+	/**
+	 *  @brief  The bytes in use by all processes, including the headers of the allocations.
+	 */
+	size_t usedBytes() const noexcept {
+		_lock();
+		const size_t used = size_t(_header->usedBytes);
+		_unlock();
+		return used;
+	}
+
+	inline bool contains(const void* ptr) const noexcept {
+		const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+		const auto base = reinterpret_cast<std::uintptr_t>(_header);
+		return address >= base and address - base < _mappedSize;
+	}
+
+	/**
+	 *  @brief  The position of ptr in the segment, which is the same in all processes.
+	 */
+	inline uint64_t offsetOf(const void* ptr) const noexcept {
+		return uint64_t(reinterpret_cast<std::uintptr_t>(ptr) - reinterpret_cast<std::uintptr_t>(_header));
+	}
+
+	inline void* at(uint64_t offset) const noexcept {
+		return reinterpret_cast<char*>(_header) + offset;
+	}
+
+private:
+	static void* _map(int fd, size_t size) {
+		void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		const int error = errno;
+		::close(fd);
+		if (address == MAP_FAILED) {
+			throw std::system_error(error, std::generic_category(), "mmap");
+		}
+		return address;
+	}
+
+	static constexpr size_t _roundUp(size_t size, size_t alignment) noexcept {
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	inline Block_* _blockAt(uint64_t offset) const noexcept {
+		return static_cast<Block_*>(at(offset));
+	}
+
+	void _lock() const noexcept {
+		while (_header->lock.exchange(1, std::memory_order_acquire) != 0) {
+			while (_header->lock.load(std::memory_order_relaxed) != 0) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void _unlock() const noexcept {
+		_header->lock.store(0, std::memory_order_release);
+	}
+};
+
+
+namespace _sharedMemory_internal {
+
+/**
+ * The control block of a ProcessSharedPtr. It lives in a SharedMemorySegment
+ * and keeps the payload inplace, like SharedPtrRefCntInplace_. There's no
+ * _dispose function pointer, because code addresses differ between processes.
+ */
+template <class T_>
+struct ProcessSharedRefCnt_ {
+	using Counting = AtomicCounting;
+	static_assert(Counting::StorageT::is_always_lock_free, "The usage count must be address-free to work across processes.");
+
+	Counting::StorageT usageCnt;
+	T_ data;
+
+	template <typename... Args>
+	ProcessSharedRefCnt_(Args&& ...args)
+		: usageCnt(1), data{std::forward<Args>(args)...}
+	{}
+};
+
+}
+
+
+/**
+ * A handle for a reference to a ProcessSharedPtr, that can be passed to
+ * another process (through a pipe, a file or the segment itself). It is the
+ * offset of the control block in the segment.
+ */
+template <class T_>
+struct ProcessSharedHandle {
+	uint64_t offset;
+};
+
+/**
+ * Like ConcurrentSharedPtr, but the control block and the payload live in a
+ * SharedMemorySegment, so several processes can hold references to the same
+ * payload. Each process has its own ProcessSharedPtrs; share() hands a
+ * reference over to another process, which adopt()s it. The last release in
+ * any process destroys the payload and returns its memory to the segment.
+ *
+ * The payload must not contain addresses: no virtual functions, and only
+ * offset pointers to other data in the segment. The segment has to outlive
+ * all ProcessSharedPtrs of the process.
+ *
+ * After a fork(), the child's copies of ProcessSharedPtrs are not counted.
+ * share() before the fork and adopt() in the child instead, and don't let the
+ * child destroy the copies (e.g. leave with _exit()).
+ */
+template <class T_>
+struct ProcessSharedPtr {
+public:
+	using T = T_;
+	using Counting = AtomicCounting;
+
+	static_assert(not std::is_polymorphic_v<T>, "A vtable pointer is not valid in other processes.");
+	static_assert(alignof(T) <= SharedMemorySegment::MAX_ALIGNMENT, "Over-aligned types can't be placed in a SharedMemorySegment.");
+
+private:
+	using RefCnt = _sharedMemory_internal::ProcessSharedRefCnt_<std::remove_const_t<T>>;
+
+	SharedMemorySegment* _segment;
+	RefCnt* _refCnt;
+
+	ProcessSharedPtr(SharedMemorySegment* segment, RefCnt* refCnt) noexcept
+		: _segment(segment), _refCnt(refCnt)
+	{}
+
+public:
+	ProcessSharedPtr() noexcept : _segment(nullptr), _refCnt(nullptr) {}
+	ProcessSharedPtr(std::nullptr_t) noexcept : ProcessSharedPtr() {}
+
+	/**
+	 *  @brief  Constructs the target inplace in segment.
+	 */
+	template <typename... Args>
+	explicit ProcessSharedPtr(SharedMemorySegment& segment, InplaceConstructorTag, Args&& ...args)
+		: _segment(&segment), _refCnt(nullptr)
+	{
+		void* memory = segment.allocate(sizeof(RefCnt), alignof(RefCnt));
+		try {
+			_refCnt = new (memory) RefCnt(std::forward<Args>(args)...);
+		} catch (...) {
+			segment.deallocate(memory);
+			throw;
+		}
+	}
+
+	ProcessSharedPtr(const ProcessSharedPtr& other) noexcept
+		: _segment(other._segment), _refCnt(other._refCnt)
+	{
+		if (_refCnt != nullptr) {
+			Counting::increment(_refCnt->usageCnt);
+		}
+	}
+
+	ProcessSharedPtr(ProcessSharedPtr&& other) noexcept
+		: _segment(std::exchange(other._segment, nullptr)), _refCnt(std::exchange(other._refCnt, nullptr))
+	{}
+
+	~ProcessSharedPtr() {
+		reset();
+	}
+
+	ProcessSharedPtr& operator =(const ProcessSharedPtr& other) noexcept {
+		ProcessSharedPtr tmp(other);
+		tmp.swap(*this);
+		return *this;
+	}
+
+	ProcessSharedPtr& operator =(ProcessSharedPtr&& other) noexcept {
+		ProcessSharedPtr tmp(std::move(other));
+		tmp.swap(*this);
+		return *this;
+	}
+
+	inline void swap(ProcessSharedPtr& other) noexcept {
+		std::swap(_segment, other._segment);
+		std::swap(_refCnt, other._refCnt);
+	}
+
+	void reset() noexcept {
+		RefCnt* refCnt = std::exchange(_refCnt, nullptr);
+		if (refCnt != nullptr and Counting::decrement(refCnt->usageCnt)) {
+			refCnt->~RefCnt();
+			_segment->deallocate(refCnt);
+		}
+		_segment = nullptr;
+	}
+
+	/**
+	 *  @brief  Adds a reference for another process, which takes it over with adopt().
+	 */
+	ProcessSharedHandle<T> share() const noexcept {
+		if (_refCnt == nullptr) {
+			return {0};
+		}
+		Counting::increment(_refCnt->usageCnt);
+		return {_segment->offsetOf(_refCnt)};
+	}
+
+	/**
+	 *  @brief  Takes over the reference of a handle that was returned by share().
+	 */
+	static ProcessSharedPtr adopt(SharedMemorySegment& segment, ProcessSharedHandle<T> handle) noexcept {
+		if (handle.offset == 0) {
+			return nullptr;
+		}
+		return ProcessSharedPtr(&segment, static_cast<RefCnt*>(segment.at(handle.offset)));
+	}
+
+	inline size_t getUsageCnt() const noexcept {
+		return _refCnt == nullptr ? 0 : Counting::load(_refCnt->usageCnt);
+	}
+
+	WeakPtr<T> getWeak() {
+		return WeakPtr<T>(___getPtr());
+	}
+
+	WeakPtr<const T> getWeak() const {
+		return WeakPtr<const T>(___getPtr());
+	}
+
+	inline T& operator *() noexcept { return *___getPtr(); }
+	inline const T& operator *() const noexcept { return *___getPtr(); }
+
+	inline T* operator ->() noexcept { return ___getPtr(); }
+	inline const T* operator ->() const noexcept { return ___getPtr(); }
+
+	inline bool operator ==(const ProcessSharedPtr& other) const noexcept { return _refCnt == other._refCnt; }
+	inline bool operator ==(std::nullptr_t) const noexcept { return _refCnt == nullptr; }
+
+	inline bool operator !=(const ProcessSharedPtr& other) const noexcept { return _refCnt != other._refCnt; }
+	inline bool operator !=(std::nullptr_t) const noexcept { return _refCnt != nullptr; }
+
+	explicit operator bool () const noexcept { return _refCnt != nullptr; }
+
+	inline T* ___getPtr() const noexcept {
+		return _refCnt == nullptr ? nullptr : &_refCnt->data;
+	}
+};
+
+}
+
+
+#endif // CAT_SHAREDMEMORY_H
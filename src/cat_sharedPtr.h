@@ -2,110 +2,557 @@
 #define CAT_SHAREDPTR_H
 
 #include "cat_weakPtr.h"
+#include "cat_owningPtr.h"
+#include "cat_slabPool.h"
+#include "cat_deferredDisposal.h"
 
+#include <atomic>
 #include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <utility>
 
 //#include <memory>
 //std::make_shared()
 
+#if defined(__GNUC__) || defined(__clang__)
+	#define CAT_NOINLINE __attribute__((noinline))
+	#define CAT_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+	#define CAT_PREFETCH_WRITE(ptr) __builtin_prefetch((ptr), 1)
+#elif defined(_MSC_VER)
+	#define CAT_NOINLINE __declspec(noinline)
+	#define CAT_UNLIKELY(cond) (cond)
+	#define CAT_PREFETCH_WRITE(ptr) ((void)(ptr))
+#else
+	#define CAT_NOINLINE
+	#define CAT_UNLIKELY(cond) (cond)
+	#define CAT_PREFETCH_WRITE(ptr) ((void)(ptr))
+#endif
+
 namespace cat {
 
+/**
+ * Counting policies for SharedPtr. They decide how the usage count of a
+ * control block is stored and modified.
+ *
+ * UnsyncedCounting is the default. It uses a plain integer and must not be
+ * used for objects that are shared between threads.
+ *
+ * add() and subtract() are optional. They let bulk operations (see
+ * cat_sharedPtrArray.h) merge the modifications of one control block.
+ *
+ * IS_LOAD_EXACT is false, if load() may return a stale or partial count on
+ * some threads (e.g. BiasedCounting). CowPtr needs an exact load, and
+ * loadAcquire(), which also makes everything that happened before the
+ * count was modified visible.
+ */
+struct UnsyncedCounting {
+	using CntT = size_t;
+	using StorageT = CntT;
+	static constexpr bool HAS_WEAK_CNT = false;
+	static constexpr bool IS_THREAD_SAFE = false;
+	static constexpr bool IS_LOAD_EXACT = true;
+
+	static inline CntT load(const StorageT& cnt) noexcept { return cnt; }
+	static inline CntT loadAcquire(const StorageT& cnt) noexcept { return cnt; }
+	static inline void increment(StorageT& cnt) noexcept { cnt += 1; }
+	/**
+	 *  @brief  Returns true, if the count dropped to zero.
+	 */
+	static inline bool decrement(StorageT& cnt) noexcept {
+		cnt -= 1;
+		return cnt == 0;
+	}
+	static inline void add(StorageT& cnt, CntT n) noexcept { cnt += n; }
+	/**
+	 *  @brief  Returns true, if the count dropped to zero.
+	 */
+	static inline bool subtract(StorageT& cnt, CntT n) noexcept {
+		cnt -= n;
+		return cnt == 0;
+	}
+	/**
+	 *  @brief  Increments cnt, unless it is zero. Returns true on success.
+	 */
+	static inline bool incrementIfNotZero(StorageT& cnt) noexcept {
+		if (cnt == 0) {
+			return false;
+		}
+		cnt += 1;
+		return true;
+	}
+};
+
+/**
+ * AtomicCounting makes copying and destroying SharedPtrs thread-safe.
+ * Increments are relaxed, because a new reference can only be created from an
+ * existing one. Decrements are acquire-release, so that all writes to the
+ * payload happen before it gets disposed by whichever thread drops the last
+ * reference.
+ */
+struct AtomicCounting {
+	using CntT = size_t;
+	using StorageT = std::atomic<CntT>;
+	static constexpr bool HAS_WEAK_CNT = false;
+	static constexpr bool IS_THREAD_SAFE = true;
+	static constexpr bool IS_LOAD_EXACT = true;
+
+	static inline CntT load(const StorageT& cnt) noexcept { return cnt.load(std::memory_order_relaxed); }
+	static inline CntT loadAcquire(const StorageT& cnt) noexcept { return cnt.load(std::memory_order_acquire); }
+	static inline void increment(StorageT& cnt) noexcept { cnt.fetch_add(1, std::memory_order_relaxed); }
+	/**
+	 *  @brief  Returns true, if the count dropped to zero.
+	 */
+	static inline bool decrement(StorageT& cnt) noexcept {
+		return cnt.fetch_sub(1, std::memory_order_acq_rel) == 1;
+	}
+	static inline void add(StorageT& cnt, CntT n) noexcept { cnt.fetch_add(n, std::memory_order_relaxed); }
+	/**
+	 *  @brief  Returns true, if the count dropped to zero.
+	 */
+	static inline bool subtract(StorageT& cnt, CntT n) noexcept {
+		return cnt.fetch_sub(n, std::memory_order_acq_rel) == n;
+	}
+	/**
+	 *  @brief  Increments cnt, unless it is zero. Returns true on success.
+	 */
+	static inline bool incrementIfNotZero(StorageT& cnt) noexcept {
+		CntT expected = cnt.load(std::memory_order_relaxed);
+		while (expected != 0) {
+			if (cnt.compare_exchange_weak(expected, expected + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+/**
+ * ObservableCounting adds a weak count to another counting policy, which is
+ * needed for ObserverPtrs. It is opt-in, so SharedPtrs that are never
+ * observed don't pay for the extra count.
+ *
+ * All SharedPtrs together hold one weak reference. Once the usage count
+ * drops to zero, the payload is destroyed and that weak reference is
+ * released. The control block is freed together with the last weak
+ * reference.
+ */
+template <class Counting_ = UnsyncedCounting>
+struct ObservableCounting {
+	using CntT = typename Counting_::CntT;
+	struct StorageT {
+		typename Counting_::StorageT usage;
+		typename Counting_::StorageT weak;
+
+		StorageT(CntT usageCnt) noexcept : usage(usageCnt), weak(1) {}
+	};
+	static constexpr bool HAS_WEAK_CNT = true;
+	static constexpr bool IS_THREAD_SAFE = Counting_::IS_THREAD_SAFE;
+	static constexpr bool IS_LOAD_EXACT = Counting_::IS_LOAD_EXACT;
+
+	static inline CntT load(const StorageT& cnt) noexcept { return Counting_::load(cnt.usage); }
+	static inline CntT loadAcquire(const StorageT& cnt) noexcept { return Counting_::loadAcquire(cnt.usage); }
+	static inline void increment(StorageT& cnt) noexcept { Counting_::increment(cnt.usage); }
+	static inline bool decrement(StorageT& cnt) noexcept { return Counting_::decrement(cnt.usage); }
+	static inline bool incrementIfNotZero(StorageT& cnt) noexcept { return Counting_::incrementIfNotZero(cnt.usage); }
+	template <class C_ = Counting_>
+	static inline auto add(StorageT& cnt, CntT n) noexcept -> decltype(C_::add(cnt.usage, n)) { return C_::add(cnt.usage, n); }
+	template <class C_ = Counting_>
+	static inline auto subtract(StorageT& cnt, CntT n) noexcept -> decltype(C_::subtract(cnt.usage, n)) { return C_::subtract(cnt.usage, n); }
+
+	static inline CntT loadWeak(const StorageT& cnt) noexcept { return Counting_::load(cnt.weak); }
+	static inline CntT loadWeakAcquire(const StorageT& cnt) noexcept { return Counting_::loadAcquire(cnt.weak); }
+	static inline void incrementWeak(StorageT& cnt) noexcept { Counting_::increment(cnt.weak); }
+	static inline bool decrementWeak(StorageT& cnt) noexcept { return Counting_::decrement(cnt.weak); }
+};
+
+
+/**
+ * The size of a cache line, as far as the layout of control blocks is concerned.
+ */
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Fallback for the opt-in below. A type opts in by declaring an overload
+ * of this function next to it (found through ADL), which is what
+ * CAT_ISOLATED_USAGE_CNT(Cls) does.
+ */
+constexpr bool ___catIsolateUsageCnt(const void*) noexcept { return false; }
+
+/**
+ * Decides whether an inplace control block puts its payload on a cache line
+ * of its own, away from the usage count. Copying the SharedPtr on one thread
+ * then doesn't evict the payload from the caches of other threads that only
+ * read it. Costs up to two cache lines per object. May also be specialized
+ * directly.
+ */
+template <class T_>
+struct IsolateUsageCnt: std::bool_constant<___catIsolateUsageCnt(static_cast<const T_*>(nullptr))> {};
+
+template <class T_>
+inline constexpr bool isolateUsageCnt_v = IsolateUsageCnt<T_>::value;
+
+/**
+ * Opts Cls into IsolateUsageCnt. Use it in the namespace of Cls, e.g. right
+ * after PTRS_FOR_CLASS(Cls).
+ */
+#define CAT_ISOLATED_USAGE_CNT(Cls) \
+	constexpr bool ___catIsolateUsageCnt(const Cls*) noexcept { return true; }
+
 namespace _sharedPtr_internal {
 
 /**
- * SharedPtrRefCnt_ is a self-deleting type. i.e. it deconstructs itself,
+ *  @brief  The alignment of the payload in an inplace control block.
+ */
+template <class T_>
+inline constexpr size_t payloadAlignment_v = isolateUsageCnt_v<T_> && alignof(T_) < CACHE_LINE_SIZE ? CACHE_LINE_SIZE : alignof(T_);
+
+template <class Counting_, class = void>
+struct HasBulkCounting: std::false_type {};
+
+template <class Counting_>
+struct HasBulkCounting<Counting_, std::void_t<
+	decltype(Counting_::add(std::declval<typename Counting_::StorageT&>(), typename Counting_::CntT())),
+	decltype(Counting_::subtract(std::declval<typename Counting_::StorageT&>(), typename Counting_::CntT()))
+>>: std::true_type {};
+
+template <class Counting_>
+inline constexpr bool hasBulkCounting_v = HasBulkCounting<Counting_>::value;
+
+
+/**
+ * BasicSharedPtrRefCnt_ is a self-deleting type. i.e. it deconstructs itself,
  * when _usageCnt reaches zero.
+ *
+ * There are no virtual functions. Every concrete control block passes a
+ * function that knows its real type to the constructor instead. That
+ * function destroys the payload and frees the control block.
  */
-struct SharedPtrRefCnt_ {
+template <class Counting_>
+struct BasicSharedPtrRefCnt_ {
 public:
-	using CntT = size_t;
+	using Counting = Counting_;
+	using CntT = typename Counting::CntT;
+	using DisposeFn = void (*)(BasicSharedPtrRefCnt_* self);
 private:
-	mutable CntT _usageCnt;
+	mutable typename Counting::StorageT _usageCnt;
+	const DisposeFn _dispose;
 
 protected:
-	SharedPtrRefCnt_(CntT usageCnt): _usageCnt(usageCnt) {}
+	BasicSharedPtrRefCnt_(CntT usageCnt, DisposeFn dispose): _usageCnt(usageCnt), _dispose(dispose) {}
+	~BasicSharedPtrRefCnt_() = default;
 
 public:
-	SharedPtrRefCnt_() = delete;
-	SharedPtrRefCnt_(const SharedPtrRefCnt_&) = delete;
-	SharedPtrRefCnt_(SharedPtrRefCnt_&&) = delete;
-	SharedPtrRefCnt_& operator =(const SharedPtrRefCnt_&) const = delete;
-	SharedPtrRefCnt_& operator =(SharedPtrRefCnt_&&) = delete;
+	BasicSharedPtrRefCnt_() = delete;
+	BasicSharedPtrRefCnt_(const BasicSharedPtrRefCnt_&) = delete;
+	BasicSharedPtrRefCnt_(BasicSharedPtrRefCnt_&&) = delete;
+	BasicSharedPtrRefCnt_& operator =(const BasicSharedPtrRefCnt_&) const = delete;
+	BasicSharedPtrRefCnt_& operator =(BasicSharedPtrRefCnt_&&) = delete;
+
+	/**
+	 *  @brief  Destroys the payload and frees this control block.
+	 *  It is kept out of line, so decUsageCnt() stays small enough to be inlined.
+	 */
+	CAT_NOINLINE void dispose() {
+		_dispose(this);
+	}
+
+	inline CntT getUsageCnt() const noexcept { return Counting::load(_usageCnt); }
+	inline CntT getUsageCntAcquire() const noexcept { return Counting::loadAcquire(_usageCnt); }
+	inline void incUsageCnt() const noexcept { Counting::increment(_usageCnt); }
+	/**
+	 *  @brief  Like n calls to incUsageCnt().
+	 */
+	inline void addUsageCnt(CntT n) const noexcept {
+		if constexpr (hasBulkCounting_v<Counting>) {
+			Counting::add(_usageCnt, n);
+		} else {
+			for (; n != 0; --n) {
+				Counting::increment(_usageCnt);
+			}
+		}
+	}
+	/**
+	 *  @brief  Like n calls to decUsageCnt(), but returns true instead of
+	 *  calling dispose(), if the count dropped to zero.
+	 */
+	inline bool subtractUsageCnt(CntT n) const noexcept {
+		if constexpr (hasBulkCounting_v<Counting>) {
+			return Counting::subtract(_usageCnt, n);
+		} else {
+			bool isZero = false;
+			for (; n != 0; --n) {
+				isZero = Counting::decrement(_usageCnt);
+			}
+			return isZero;
+		}
+	}
+	inline void decUsageCnt() {
+		if (CAT_UNLIKELY(Counting::decrement(_usageCnt))) {
+			dispose();
+		}
+	}
+
+	// only available with ObservableCounting:
+	inline bool tryIncUsageCnt() const noexcept { return Counting::incrementIfNotZero(_usageCnt); }
+	inline CntT getWeakCnt() const noexcept { return Counting::loadWeak(_usageCnt); }
+	inline CntT getWeakCntAcquire() const noexcept { return Counting::loadWeakAcquire(_usageCnt); }
+	inline void incWeakCnt() const noexcept { Counting::incrementWeak(_usageCnt); }
+	inline void decWeakCnt() {
+		if (CAT_UNLIKELY(Counting::decrementWeak(_usageCnt))) {
+			dispose();
+		}
+	}
+
+protected:
+	/**
+	 *  @brief  The DisposeFn of every concrete control block Self_. It calls
+	 *  Self_::_destroyPayload() and Self_::_deallocate(self).
+	 *  With a weak count, it is called twice: once when the usage count drops
+	 *  to zero (the weak count is still at least one) and once when the weak
+	 *  count drops to zero.
+	 *  Payloads of types that opted in with CAT_DEFERRED_DISPOSAL(Cls) are
+	 *  left to cat::reclaim().
+	 */
+	template <class Self_>
+	static void disposeImpl(BasicSharedPtrRefCnt_* base) {
+		if constexpr (useDeferredDisposal_v<typename Self_::T>) {
+			if (base->_hasPayload() && DeferredDisposal::defer(base, &_disposeDeferred<Self_>)) {
+				return;
+			}
+		}
+		_disposeNow<Self_>(base);
+	}
 
-	virtual void dispose(void* payload) = 0;
+private:
+	template <class Self_>
+	static void _disposeNow(BasicSharedPtrRefCnt_* base) {
+		auto* self = static_cast<Self_*>(base);
+		if constexpr (Counting::HAS_WEAK_CNT) {
+			if (Counting::loadWeak(self->_usageCnt) != 0) {
+				self->_destroyPayload();
+				if (not Counting::decrementWeak(self->_usageCnt)) {
+					return;
+				}
+			}
+		} else {
+			self->_destroyPayload();
+		}
+		Self_::_deallocate(self);
+	}
 
-	virtual ~SharedPtrRefCnt_() {};
+	template <class Self_>
+	static void _disposeDeferred(void* base) {
+		_disposeNow<Self_>(static_cast<BasicSharedPtrRefCnt_*>(base));
+	}
 
-	inline const CntT& getUsageCnt() const noexcept { return _usageCnt; }
-	inline void incUsageCnt() const noexcept { _usageCnt += 1; }
-	inline void decUsageCnt(void* payload) {
-		_usageCnt -= 1;
-		if (_usageCnt == 0) {
-			dispose(payload);
+	/**
+	 *  @brief  False, if only the control block is left to be freed.
+	 */
+	bool _hasPayload() const noexcept {
+		if constexpr (Counting::HAS_WEAK_CNT) {
+			return Counting::loadWeak(_usageCnt) != 0;
+		} else {
+			return true;
 		}
 	}
 };
 
+using SharedPtrRefCnt_ = BasicSharedPtrRefCnt_<UnsyncedCounting>;
 
-template <class T_>
-struct SharedPtrRefCntSeparate_ final: public SharedPtrRefCnt_ {
+
+/**
+ * Control block for a payload that was allocated on its own. It remembers the
+ * original pointer, because the pointers held by SharedPtrs may have been
+ * cast to a different base. The payload is destroyed with Deleter_, which
+ * comes from the adopted OwningPtr.
+ */
+template <class T_, class Counting_ = UnsyncedCounting, class Deleter_ = DefaultDelete>
+struct SharedPtrRefCntSeparate_ final: public BasicSharedPtrRefCnt_<Counting_>, private Deleter_ {
 public:
 	using T = T_;
+	using Base = BasicSharedPtrRefCnt_<Counting_>;
+
+private:
+	T* _ptr;
 
 public:
-	SharedPtrRefCntSeparate_(typename SharedPtrRefCnt_::CntT usageCnt): SharedPtrRefCnt_(usageCnt) {}
+	SharedPtrRefCntSeparate_(typename Base::CntT usageCnt, T* ptr): Base(usageCnt, &Base::template disposeImpl<SharedPtrRefCntSeparate_>), _ptr(ptr) {}
+	SharedPtrRefCntSeparate_(typename Base::CntT usageCnt, T* ptr, Deleter_ deleter)
+		: Base(usageCnt, &Base::template disposeImpl<SharedPtrRefCntSeparate_>),
+		  Deleter_(std::move(deleter)),
+		  _ptr(ptr)
+	{}
 	// delete them all:
 	SharedPtrRefCntSeparate_() = delete;
 	SharedPtrRefCntSeparate_(const SharedPtrRefCntSeparate_&) = delete;
 
-	virtual void dispose(void* payload) override {
-		T* data = reinterpret_cast<T*>(payload);
-		delete data;
-		delete this;
+	T* get() { return _ptr; }
+
+private:
+	friend Base;
+
+	void _destroyPayload() {
+		static_cast<Deleter_&>(*this)(_ptr);
 	}
 
-	virtual ~SharedPtrRefCntSeparate_() { /* NOP() */}
+	static void _deallocate(SharedPtrRefCntSeparate_* self) {
+		delete self;
+	}
 };
 
 
-template <class T_>
-struct SharedPtrRefCntInplace_ final: public SharedPtrRefCnt_ {
+template <class T_, class Counting_ = UnsyncedCounting>
+struct SharedPtrRefCntInplace_ final: public BasicSharedPtrRefCnt_<Counting_> {
 public:
 	using T = T_;
+	using Base = BasicSharedPtrRefCnt_<Counting_>;
 public:
-	mutable T  data;
+	// a union, so the lifetime of data can end before the one of the control block.
+	union {
+		alignas(payloadAlignment_v<T>) mutable T  data;
+	};
 
-	SharedPtrRefCntInplace_(typename SharedPtrRefCnt_::CntT usageCnt): SharedPtrRefCnt_(usageCnt) {}
 	// delete them all:
 	SharedPtrRefCntInplace_() = delete;
 	SharedPtrRefCntInplace_(const SharedPtrRefCntInplace_&) = delete;
 
 	template <class... Args>
-	explicit SharedPtrRefCntInplace_(typename SharedPtrRefCnt_::CntT usageCnt, Args&& ...args)
-		: SharedPtrRefCnt_(usageCnt),
+	explicit SharedPtrRefCntInplace_(typename Base::CntT usageCnt, Args&& ...args)
+		: Base(usageCnt, &Base::template disposeImpl<SharedPtrRefCntInplace_>),
 		  data{std::forward<Args>(args)...}
 	{}
 
-	virtual void dispose([[maybe_unused]]void* payload) override {
-		delete this;
+	/**
+	 *  @brief  Does not destroy data, that is done by dispose().
+	 */
+	~SharedPtrRefCntInplace_() {}
+
+	T* get() { return &data; }
+
+	/**
+	 * Types that opted in with CAT_POOLED_ALLOCATION(Cls) get their control
+	 * blocks from a SlabPool.
+	 */
+	static void* operator new(size_t size) {
+		if constexpr (usePooledAllocation_v<T>) {
+			return Pool<>::allocate();
+		} else {
+			return ::operator new(size);
+		}
+	}
+
+	static void* operator new(size_t size, std::align_val_t alignment) {
+		if constexpr (usePooledAllocation_v<T>) {
+			return Pool<>::allocate();
+		} else {
+			return ::operator new(size, alignment);
+		}
+	}
+
+	static void operator delete(void* ptr) noexcept {
+		if constexpr (usePooledAllocation_v<T>) {
+			Pool<>::deallocate(ptr);
+		} else {
+			::operator delete(ptr);
+		}
+	}
+
+	static void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+		if constexpr (usePooledAllocation_v<T>) {
+			Pool<>::deallocate(ptr);
+		} else {
+			::operator delete(ptr, alignment);
+		}
+	}
+
+private:
+	template <class Self_ = SharedPtrRefCntInplace_>
+	using Pool = SlabPool<sizeof(Self_), alignof(Self_)>;
+
+	friend Base;
+
+	void _destroyPayload() {
+		std::destroy_at(&data);
+	}
+
+	static void _deallocate(SharedPtrRefCntInplace_* self) {
+		delete self;
+	}
+};
+
+
+/**
+ * Like SharedPtrRefCntInplace_, but allocated from a std::pmr::memory_resource,
+ * which it remembers for the deallocation.
+ */
+template <class T_, class Counting_ = UnsyncedCounting>
+struct SharedPtrRefCntPmrInplace_ final: public BasicSharedPtrRefCnt_<Counting_> {
+public:
+	using T = T_;
+	using Base = BasicSharedPtrRefCnt_<Counting_>;
+private:
+	std::pmr::memory_resource* const _resource;
+public:
+	union {
+		alignas(payloadAlignment_v<T>) mutable T  data;
+	};
+
+	// delete them all:
+	SharedPtrRefCntPmrInplace_() = delete;
+	SharedPtrRefCntPmrInplace_(const SharedPtrRefCntPmrInplace_&) = delete;
+
+	template <class... Args>
+	explicit SharedPtrRefCntPmrInplace_(std::pmr::memory_resource* resource, typename Base::CntT usageCnt, Args&& ...args)
+		: Base(usageCnt, &Base::template disposeImpl<SharedPtrRefCntPmrInplace_>),
+		  _resource(resource),
+		  data{std::forward<Args>(args)...}
+	{}
+
+	~SharedPtrRefCntPmrInplace_() {}
+
+	template <class... Args>
+	static SharedPtrRefCntPmrInplace_* create(std::pmr::memory_resource* resource, typename Base::CntT usageCnt, Args&& ...args) {
+		void* storage = resource->allocate(sizeof(SharedPtrRefCntPmrInplace_), alignof(SharedPtrRefCntPmrInplace_));
+		try {
+			return new (storage) SharedPtrRefCntPmrInplace_(resource, usageCnt, std::forward<Args>(args)...);
+		} catch (...) {
+			resource->deallocate(storage, sizeof(SharedPtrRefCntPmrInplace_), alignof(SharedPtrRefCntPmrInplace_));
+			throw;
+		}
 	}
 
-	virtual ~SharedPtrRefCntInplace_() { /* NOP() */}
+	std::pmr::memory_resource* resource() const noexcept { return _resource; }
 
 	T* get() { return &data; }
+
+private:
+	friend Base;
+
+	void _destroyPayload() {
+		std::destroy_at(&data);
+	}
+
+	static void _deallocate(SharedPtrRefCntPmrInplace_* self) {
+		std::pmr::memory_resource* resource = self->_resource;
+		self->~SharedPtrRefCntPmrInplace_();
+		resource->deallocate(self, sizeof(SharedPtrRefCntPmrInplace_), alignof(SharedPtrRefCntPmrInplace_));
+	}
 };
 
 
-template <class T_>
+template <class T_, class Counting_ = UnsyncedCounting>
 struct SharedPtrData_ {
-	WeakPtr<SharedPtrRefCnt_> refCnt = nullptr;
+	using RefCnt = BasicSharedPtrRefCnt_<Counting_>;
+
+	WeakPtr<RefCnt> refCnt = nullptr;
 	WeakPtr<T_> payload = nullptr;
 
 	inline SharedPtrData_(std::nullptr_t) noexcept
 	{ }
 
-	inline SharedPtrData_(WeakPtr<SharedPtrRefCnt_> refCnt, WeakPtr<T_> payload) noexcept
+	inline SharedPtrData_(WeakPtr<RefCnt> refCnt, WeakPtr<T_> payload) noexcept
 		: refCnt(refCnt),
 		  payload(payload)
 	{
@@ -117,7 +564,7 @@ struct SharedPtrData_ {
 	{}
 
 	template<class T2_, std::enable_if_t<std::is_base_of_v<T_, T2_>, int> = 0>
-	inline explicit SharedPtrData_(const SharedPtrData_<T2_>& other) noexcept
+	inline explicit SharedPtrData_(const SharedPtrData_<T2_, Counting_>& other) noexcept
 		: SharedPtrData_(other.refCnt, other.payload)
 	{}
 
@@ -129,11 +576,28 @@ struct SharedPtrData_ {
 		other.payload = nullptr;
 	}
 
+	/**
+	 *  @brief  Takes over the usage count of other without touching it.
+	 */
+	template<class T2_, std::enable_if_t<std::is_base_of_v<T_, T2_>, int> = 0>
+	inline explicit SharedPtrData_(SharedPtrData_<T2_, Counting_>&& other) noexcept
+		: refCnt(other.refCnt),
+		  payload(other.payload.___getPtr())
+	{
+		other.refCnt = nullptr;
+		other.payload = nullptr;
+	}
+
 	inline void set(const SharedPtrData_& other) {
 		set(other.refCnt, other.payload);
 	}
 
-	void set(WeakPtr<SharedPtrRefCnt_> refCnt, WeakPtr<T_> payload) {
+	void set(WeakPtr<RefCnt> refCnt, WeakPtr<T_> payload) {
+		if (refCnt == this->refCnt) {
+			// the same control block, so there is no need to increment and decrement its usage count.
+			this->payload = payload;
+			return;
+		}
 		auto oldRefCnt = this->refCnt;
 		_incRefCnt(refCnt);
 		this->refCnt = refCnt;
@@ -141,6 +605,15 @@ struct SharedPtrData_ {
 		_decRefCnt(oldRefCnt);
 	}
 
+	/**
+	 *  @brief  Like set(), but takes over a usage count that was already
+	 *  incremented. this must be null.
+	 */
+	inline void adopt(WeakPtr<RefCnt> refCnt, WeakPtr<T_> payload) noexcept {
+		this->refCnt = refCnt;
+		this->payload = payload;
+	}
+
 	void reset() {
 		_decRefCnt(this->refCnt);
 		this->refCnt = nullptr;
@@ -157,31 +630,111 @@ struct SharedPtrData_ {
 	}
 
 private:
-	void _incRefCnt(const WeakPtr<SharedPtrRefCnt_> ptr) const  noexcept {
+	void _incRefCnt(const WeakPtr<RefCnt> ptr) const  noexcept {
 		if (ptr != nullptr) {
 			ptr->incUsageCnt();
 		}
 	}
 
-	void _decRefCnt(WeakPtr<SharedPtrRefCnt_> ptr) {
+	void _decRefCnt(WeakPtr<RefCnt> ptr) {
 		if (ptr != nullptr) {
-			ptr->decUsageCnt(payload.___getPtr());
+			ptr->decUsageCnt();
 		}
 	}
 };
 
 }
 
-template <class T_>
+
+/**
+ * The deleter of PromotableOwningPtr. The target is created inside an inplace
+ * control block with a usage count of zero, so SharedPtr(OwningPtr&&) can
+ * adopt it without another allocation. Until then the OwningPtr is the only
+ * owner and the control block is never touched. An OwningPtr with this
+ * deleter is two pointers wide.
+ */
+template <class Counting_ = UnsyncedCounting>
+struct PromotableDelete {
+	using Counting = Counting_;
+	using RefCnt = _sharedPtr_internal::BasicSharedPtrRefCnt_<Counting>;
+
+private:
+	RefCnt* _refCnt = nullptr;
+
+public:
+	PromotableDelete() noexcept = default;
+
+	inline RefCnt* refCnt() const noexcept { return _refCnt; }
+
+	/**
+	 *  @brief  Called by OwningPtr(InplaceConstructorTag, ...).
+	 */
+	template <class T_, class... Args_>
+	T_* create(Args_&&... args) {
+		auto* refCnt = new _sharedPtr_internal::SharedPtrRefCntInplace_<std::remove_const_t<T_>, Counting>(0, std::forward<Args_>(args)...);
+		_refCnt = refCnt;
+		return &refCnt->data;
+	}
+
+	template <class T_>
+	void operator()(T_*) const {
+		_refCnt->dispose();
+	}
+};
+
+template <class Counting_>
+struct DeleterCreatesTarget<PromotableDelete<Counting_>>: std::true_type {};
+
+/**
+ * An OwningPtr that can be turned into a SharedPtr with the same counting
+ * policy for free:
+ *   PromotableOwningPtr<Circle> circle{{}, 7.5, Position(...)};
+ *   ... // build phase
+ *   SharedPtr<Circle> shared = std::move(circle); // no allocation.
+ */
+template <class T_, class Counting_ = UnsyncedCounting>
+using PromotableOwningPtr = OwningPtr<T_, PromotableDelete<Counting_>>;
+
+
+template <class T_, class Counting_>
+struct CompactSharedPtr;
+
+template <class T_, class Counting_>
+struct ObserverPtr;
+
+template <class T_, class Counting_>
+class CowPtr;
+
+namespace _sharedPtr_internal {
+struct SharedPtrBulk_;
+}
+
+/**
+ * The counting policy decides whether the usage count may be modified from
+ * several threads at once. See UnsyncedCounting and AtomicCounting.
+ */
+template <class T_, class Counting_ = UnsyncedCounting>
 struct SharedPtr {
 public:
 	using T = T_;
+	using Counting = Counting_;
 private:
-	_sharedPtr_internal::SharedPtrData_<T> _ptrData;
+	_sharedPtr_internal::SharedPtrData_<T, Counting> _ptrData;
 
-	template<typename T2_>
+	template<typename T2_, class Counting2_>
 	friend struct SharedPtr;
 
+	template<typename T2_, class Counting2_>
+	friend struct CompactSharedPtr;
+
+	template<typename T2_, class Counting2_>
+	friend struct ObserverPtr;
+
+	template<typename T2_, class Counting2_>
+	friend class CowPtr;
+
+	friend struct _sharedPtr_internal::SharedPtrBulk_;
+
 public:
 
 	SharedPtr(const SharedPtr& other)
@@ -192,21 +745,62 @@ public:
 		: _ptrData(std::move(other._ptrData))
 	{}
 
-	template<class T2_, std::enable_if_t<std::is_base_of_v<T, T2_> && std::is_polymorphic_v<T>, int> = 0>
-	SharedPtr(const SharedPtr<T2_>& other)
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_base_of_v<Self_, T2_> && std::is_polymorphic_v<Self_>, int> = 0>
+	SharedPtr(const SharedPtr<T2_, Counting>& other)
 		: _ptrData(other._ptrData)
 	{
 		auto* staticCheckConvertabiity = static_cast<T*>(static_cast<T2_*>(nullptr));
 	}
 
+	/**
+	 *  @brief  Takes over the reference of other without touching the usage count.
+	 */
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_base_of_v<Self_, T2_> && std::is_polymorphic_v<Self_>, int> = 0>
+	SharedPtr(SharedPtr<T2_, Counting>&& other) noexcept
+		: _ptrData(std::move(other._ptrData))
+	{}
+
 	template <typename... Args>
 	explicit SharedPtr(InplaceConstructorTag, Args&& ...args)
 		: _ptrData(nullptr)
 	{
-		auto* refCntPtr = new _sharedPtr_internal::SharedPtrRefCntInplace_<T>(0, std::forward<Args>(args)...);
+		auto* refCntPtr = new _sharedPtr_internal::SharedPtrRefCntInplace_<std::remove_const_t<T>, Counting>(0, std::forward<Args>(args)...);
 		_ptrData.set(refCntPtr, &refCntPtr->data);
 	}
 
+	/**
+	 *  @brief  Like SharedPtr(InplaceConstructorTag, ...), but allocates the
+	 *  control block together with the target from resource.
+	 */
+	template <typename... Args>
+	explicit SharedPtr(std::pmr::memory_resource* resource, InplaceConstructorTag, Args&& ...args)
+		: _ptrData(nullptr)
+	{
+		auto* refCntPtr = _sharedPtr_internal::SharedPtrRefCntPmrInplace_<std::remove_const_t<T>, Counting>::create(resource, 0, std::forward<Args>(args)...);
+		_ptrData.set(refCntPtr, &refCntPtr->data);
+	}
+
+	/**
+	 *  @brief  Takes over the target of owning. Allocates a separate control
+	 *  block, that destroys the target with the deleter of owning, unless
+	 *  owning is a PromotableOwningPtr with the same counting policy.
+	 */
+	template<class T2_, class Deleter_, std::enable_if_t<std::is_convertible_v<T2_*, T*>, int> = 0>
+	SharedPtr(OwningPtr<T2_, Deleter_>&& owning)
+		: _ptrData(nullptr)
+	{
+		if (owning == nullptr) {
+			return;
+		}
+		if constexpr (std::is_same_v<Deleter_, PromotableDelete<Counting>>) {
+			_ptrData.set(owning.getDeleter().refCnt(), owning.release());
+		} else {
+			using RefCnt = _sharedPtr_internal::SharedPtrRefCntSeparate_<T2_, Counting, Deleter_>;
+			auto* refCntPtr = new RefCnt(0, owning.___getPtr(), std::move(owning.getDeleter()));
+			_ptrData.set(refCntPtr, owning.release());
+		}
+	}
+
 	template<class TNullptr, std::enable_if_t<std::is_same_v<TNullptr, std::nullptr_t>, int> = 0>
 	SharedPtr(TNullptr _) noexcept : _ptrData(_) {}
 
@@ -226,6 +820,19 @@ public:
 		return *this;
 	}
 
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_base_of_v<Self_, T2_> && std::is_polymorphic_v<Self_>, int> = 0>
+	SharedPtr& operator=(const SharedPtr<T2_, Counting>& other) {
+		_ptrData.set(other._ptrData.refCnt, other.___getPtr());
+		return *this;
+	}
+
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_base_of_v<Self_, T2_> && std::is_polymorphic_v<Self_>, int> = 0>
+	SharedPtr& operator=(SharedPtr<T2_, Counting>&& other) noexcept {
+		SharedPtr tmp(std::move(other));
+		tmp.swap(*this);
+		return *this;
+	}
+
 public:
 
 	inline void swap(SharedPtr& other) noexcept {
@@ -241,11 +848,11 @@ public:
 	}
 
 	/**
-	 *  @brief  Performs a dynamic_cast<>().
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
 	 */
 	template<class T2_>
 	auto as() const -> WeakPtr<T2_> {
-		return WeakPtr<T2_>(dynamic_cast<T2_*>(___getPtr()));
+		return WeakPtr<T2_>(kindCast<T2_>(___getPtr()));
 	}
 
 	/**
@@ -259,30 +866,57 @@ public:
 	/**
 	 *  @brief  Performs a dynamic_cast<>().
 	 */
-	template<class T2_, std::enable_if_t<std::is_polymorphic_v<T> && std::is_polymorphic_v<T2_>, int> = 0>
-	SharedPtr<T2_> asShared() const {
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asShared() const & {
 		auto castPtr = as<T2_>();
 
 		if (castPtr) {
-			auto result = SharedPtr<T2_>(nullptr);
+			auto result = SharedPtr<T2_, Counting>(nullptr);
 			result._ptrData.set(this->_ptrData.refCnt, castPtr);
 			return result;
 		}
-		return SharedPtr<T2_>(nullptr);
+		return SharedPtr<T2_, Counting>(nullptr);
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>() and hands the reference over to
+	 *  the result without touching the usage count. this stays unchanged,
+	 *  if the cast fails.
+	 */
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asShared() && {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		if (auto castPtr = as<T2_>()) {
+			result._ptrData.adopt(this->_ptrData.refCnt, castPtr);
+			this->_ptrData.adopt(nullptr, nullptr);
+		}
+		return result;
 	}
 
 	/**
 	 *  @brief  Performs a static_cast<>().
 	 */
-	template<class T2_, std::enable_if_t<std::is_polymorphic_v<T> && std::is_polymorphic_v<T2_>, int> = 0>
-	SharedPtr<T2_> asSharedStatic() const {
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asSharedStatic() const & {
 		auto castPtr = asStatic<T2_>();
 
-		auto result = SharedPtr<T2_>(nullptr);
+		auto result = SharedPtr<T2_, Counting>(nullptr);
 		result._ptrData.set(this->_ptrData.refCnt, castPtr);
 		return result;
 	}
 
+	/**
+	 *  @brief  Performs a static_cast<>() and hands the reference over to the
+	 *  result without touching the usage count.
+	 */
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asSharedStatic() && {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		result._ptrData.adopt(this->_ptrData.refCnt, asStatic<T2_>());
+		this->_ptrData.adopt(nullptr, nullptr);
+		return result;
+	}
+
 	inline T& operator*() noexcept { return *___getPtr(); }
 	inline const T& operator*() const noexcept { return *___getPtr(); }
 
@@ -306,12 +940,374 @@ public:
 	}
 };
 
-}
 
+/**
+ * CompactSharedPtr is a SharedPtr that is only a single pointer wide. It can
+ * only point to objects that were created with the InplaceConstructorTag,
+ * because the payload address is derived from the control block.
+ * Anything that needs a different payload address (e.g.: asShared<>()) results
+ * in a regular SharedPtr.
+ */
+template <class T_, class Counting_ = UnsyncedCounting>
+struct CompactSharedPtr {
+public:
+	using T = T_;
+	using Counting = Counting_;
+private:
+	using RefCnt = _sharedPtr_internal::SharedPtrRefCntInplace_<std::remove_const_t<T>, Counting>;
+
+	RefCnt* _refCnt;
+
+	template<typename T2_, class Counting2_>
+	friend struct CompactSharedPtr;
+
+	template<typename T2_, class Counting2_>
+	friend struct ObserverPtr;
+
+public:
+	CompactSharedPtr(const CompactSharedPtr& other) noexcept
+		: _refCnt(other._refCnt)
+	{
+		_incRefCnt();
+	}
+
+	CompactSharedPtr(CompactSharedPtr&& other) noexcept
+		: _refCnt(other._refCnt)
+	{
+		other._refCnt = nullptr;
+	}
+
+	template<class T2_, std::enable_if_t<std::is_same_v<T, const T2_>, int> = 0>
+	CompactSharedPtr(const CompactSharedPtr<T2_, Counting>& other) noexcept
+		: _refCnt(other._refCnt)
+	{
+		_incRefCnt();
+	}
+
+	template <typename... Args>
+	explicit CompactSharedPtr(InplaceConstructorTag, Args&& ...args)
+		: _refCnt(new RefCnt(1, std::forward<Args>(args)...))
+	{}
+
+	template<class TNullptr, std::enable_if_t<std::is_same_v<TNullptr, std::nullptr_t>, int> = 0>
+	CompactSharedPtr(TNullptr) noexcept : _refCnt(nullptr) {}
+
+	~CompactSharedPtr() {
+		if (_refCnt != nullptr) {
+			_refCnt->decUsageCnt();
+		}
+	}
+
+public:
+	CompactSharedPtr& operator=(const CompactSharedPtr& other) {
+		CompactSharedPtr tmp(other);
+		tmp.swap(*this);
+		return *this;
+	}
+
+	CompactSharedPtr& operator=(CompactSharedPtr&& other) noexcept {
+		other.swap(*this);
+		return *this;
+	}
+
+public:
+	template<class T2_, std::enable_if_t<std::is_base_of_v<T2_, T>, int> = 0>
+	operator SharedPtr<T2_, Counting>() const & {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		if (_refCnt != nullptr) {
+			result._ptrData.set(_refCnt, static_cast<T2_*>(___getPtr()));
+		}
+		return result;
+	}
+
+	/**
+	 *  @brief  Hands the reference over without touching the usage count.
+	 */
+	template<class T2_, std::enable_if_t<std::is_base_of_v<T2_, T>, int> = 0>
+	operator SharedPtr<T2_, Counting>() && {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		if (_refCnt != nullptr) {
+			result._ptrData.adopt(_refCnt, static_cast<T2_*>(___getPtr()));
+			_refCnt = nullptr;
+		}
+		return result;
+	}
+
+	inline void swap(CompactSharedPtr& other) noexcept {
+		std::swap(_refCnt, other._refCnt);
+	}
+
+	WeakPtr<T> getWeak() {
+		return WeakPtr<T>(___getPtr());
+	}
+
+	WeakPtr<const T> getWeak() const {
+		return WeakPtr<const T>(___getPtr());
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
+	 */
+	template<class T2_>
+	auto as() const -> WeakPtr<T2_> {
+		return WeakPtr<T2_>(kindCast<T2_>(___getPtr()));
+	}
+
+	/**
+	 *  @brief  Performs a static_cast<>().
+	 */
+	template<class T2_>
+	auto asStatic() const -> WeakPtr<T2_> {
+		return WeakPtr<T2_>(static_cast<T2_*>(___getPtr()));
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>().
+	 */
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asShared() const & {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		if (auto castPtr = as<T2_>()) {
+			result._ptrData.set(_refCnt, castPtr);
+		}
+		return result;
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>() and hands the reference over to
+	 *  the result without touching the usage count. this stays unchanged,
+	 *  if the cast fails.
+	 */
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asShared() && {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		if (auto castPtr = as<T2_>()) {
+			result._ptrData.adopt(_refCnt, castPtr);
+			_refCnt = nullptr;
+		}
+		return result;
+	}
+
+	/**
+	 *  @brief  Performs a static_cast<>().
+	 */
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asSharedStatic() const & {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		if (_refCnt != nullptr) {
+			result._ptrData.set(_refCnt, asStatic<T2_>());
+		}
+		return result;
+	}
+
+	/**
+	 *  @brief  Performs a static_cast<>() and hands the reference over to the
+	 *  result without touching the usage count.
+	 */
+	template<class T2_, class Self_ = T, std::enable_if_t<std::is_polymorphic_v<Self_> && std::is_polymorphic_v<T2_>, int> = 0>
+	SharedPtr<T2_, Counting> asSharedStatic() && {
+		auto result = SharedPtr<T2_, Counting>(nullptr);
+		if (_refCnt != nullptr) {
+			result._ptrData.adopt(_refCnt, asStatic<T2_>());
+			_refCnt = nullptr;
+		}
+		return result;
+	}
+
+	inline T& operator*() noexcept { return *___getPtr(); }
+	inline const T& operator*() const noexcept { return *___getPtr(); }
+
+	inline T* operator->() noexcept { return ___getPtr(); }
+	inline const T* operator->() const noexcept { return ___getPtr(); }
+
+	bool operator ==(const CompactSharedPtr& other) const noexcept { return _refCnt == other._refCnt; }
+	bool operator ==(std::nullptr_t) const noexcept { return _refCnt == nullptr; }
+
+	bool operator !=(const CompactSharedPtr& other) const noexcept { return _refCnt != other._refCnt; }
+	bool operator !=(std::nullptr_t) const noexcept { return _refCnt != nullptr; }
+
+	explicit operator bool () const noexcept { return _refCnt != nullptr; }
+
+	inline T* ___getPtr() const noexcept {
+		return _refCnt != nullptr ? _refCnt->get() : nullptr;
+	}
+
+private:
+	inline void _incRefCnt() const noexcept {
+		if (_refCnt != nullptr) {
+			_refCnt->incUsageCnt();
+		}
+	}
+};
+
+/**
+ * A SharedPtr that may be copied and destroyed concurrently from several
+ * threads. The pointee itself is not synchronized.
+ */
+template <class T_>
+using ConcurrentSharedPtr = SharedPtr<T_, AtomicCounting>;
+
+
+/**
+ * ObserverPtr does not own its target, but unlike WeakPtr it knows, when its
+ * target has been destroyed. It can only observe SharedPtrs and
+ * CompactSharedPtrs that use ObservableCounting.
+ */
+template <class T_, class Counting_ = ObservableCounting<>>
+struct ObserverPtr {
+	static_assert(Counting_::HAS_WEAK_CNT, "An ObserverPtr needs the ObservableCounting policy.");
+public:
+	using T = T_;
+	using Counting = Counting_;
+private:
+	using RefCnt = _sharedPtr_internal::BasicSharedPtrRefCnt_<Counting>;
+
+	RefCnt* _refCnt;
+	T* _ptr;
+
+	template<typename T2_, class Counting2_>
+	friend struct ObserverPtr;
+
+public:
+	ObserverPtr(const ObserverPtr& other) noexcept
+		: ObserverPtr(other._refCnt, other._ptr)
+	{}
+
+	ObserverPtr(ObserverPtr&& other) noexcept
+		: _refCnt(other._refCnt),
+		  _ptr(other._ptr)
+	{
+		other._refCnt = nullptr;
+		other._ptr = nullptr;
+	}
+
+	template<class T2_, std::enable_if_t<std::is_convertible_v<T2_*, T*>, int> = 0>
+	ObserverPtr(const ObserverPtr<T2_, Counting>& other) noexcept
+		: ObserverPtr(other._refCnt, other._ptr)
+	{}
+
+	template<class T2_, std::enable_if_t<std::is_convertible_v<T2_*, T*>, int> = 0>
+	ObserverPtr(const SharedPtr<T2_, Counting>& shared) noexcept
+		: ObserverPtr(shared._ptrData.refCnt.___getPtr(), shared.___getPtr())
+	{}
+
+	template<class T2_, std::enable_if_t<std::is_convertible_v<T2_*, T*>, int> = 0>
+	ObserverPtr(const CompactSharedPtr<T2_, Counting>& shared) noexcept
+		: ObserverPtr(shared._refCnt, shared.___getPtr())
+	{}
+
+	template<class TNullptr, std::enable_if_t<std::is_same_v<TNullptr, std::nullptr_t>, int> = 0>
+	ObserverPtr(TNullptr) noexcept : _refCnt(nullptr), _ptr(nullptr) {}
+
+	~ObserverPtr() {
+		if (_refCnt != nullptr) {
+			_refCnt->decWeakCnt();
+		}
+	}
+
+private:
+	ObserverPtr(RefCnt* refCnt, T* ptr) noexcept
+		: _refCnt(refCnt),
+		  _ptr(ptr)
+	{
+		if (_refCnt != nullptr) {
+			_refCnt->incWeakCnt();
+		}
+	}
+
+public:
+	ObserverPtr& operator=(const ObserverPtr& other) {
+		ObserverPtr tmp(other);
+		tmp.swap(*this);
+		return *this;
+	}
+
+	ObserverPtr& operator=(ObserverPtr&& other) noexcept {
+		other.swap(*this);
+		return *this;
+	}
+
+public:
+	inline void swap(ObserverPtr& other) noexcept {
+		std::swap(_refCnt, other._refCnt);
+		std::swap(_ptr, other._ptr);
+	}
+
+	/**
+	 *  @brief  Returns true, if the target has been destroyed (or if this is null).
+	 */
+	bool expired() const noexcept {
+		return _refCnt == nullptr || _refCnt->getUsageCnt() == 0;
+	}
+
+	/**
+	 *  @brief  Returns a SharedPtr to the target, or nullptr if it has
+	 *  already been destroyed.
+	 */
+	SharedPtr<T, Counting> lock() const noexcept {
+		auto result = SharedPtr<T, Counting>(nullptr);
+		if (_refCnt != nullptr && _refCnt->tryIncUsageCnt()) {
+			result._ptrData.adopt(_refCnt, _ptr);
+		}
+		return result;
+	}
+
+	bool operator ==(const ObserverPtr& other) const noexcept { return _refCnt == other._refCnt && _ptr == other._ptr; }
+	bool operator ==(std::nullptr_t) const noexcept { return _refCnt == nullptr; }
+
+	bool operator !=(const ObserverPtr& other) const noexcept { return not (*this == other); }
+	bool operator !=(std::nullptr_t) const noexcept { return _refCnt != nullptr; }
+
+	/**
+	 *  @brief  The target address, even if it has been destroyed. Must not be
+	 *  dereferenced without a lock().
+	 */
+	inline T* ___getPtr() const noexcept {
+		return _ptr;
+	}
+};
+
+/**
+ * SharedPtrs that can be observed by an ObserverPtr.
+ */
+template <class T_>
+using ObservableSharedPtr = SharedPtr<T_, ObservableCounting<UnsyncedCounting>>;
 
 template <class T_>
-struct std::hash<cat::SharedPtr<T_>> {
-	size_t operator()(const cat::SharedPtr<T_>& v) const noexcept {
+using ConcurrentObservableSharedPtr = SharedPtr<T_, ObservableCounting<AtomicCounting>>;
+
+template <class T_>
+using ConcurrentObserverPtr = ObserverPtr<T_, ObservableCounting<AtomicCounting>>;
+
+template <class T_, class Counting_>
+struct IsTriviallyRelocatable<SharedPtr<T_, Counting_>>: std::true_type {};
+
+template <class T_, class Counting_>
+struct IsTriviallyRelocatable<CompactSharedPtr<T_, Counting_>>: std::true_type {};
+
+template <class T_, class Counting_>
+struct IsTriviallyRelocatable<ObserverPtr<T_, Counting_>>: std::true_type {};
+
+}
+
+
+template <class T_, class Counting_>
+struct std::hash<cat::SharedPtr<T_, Counting_>> {
+	size_t operator()(const cat::SharedPtr<T_, Counting_>& v) const noexcept {
+		return std::hash<T_*>()(v.___getPtr());
+	}
+};
+
+template <class T_, class Counting_>
+struct std::hash<cat::CompactSharedPtr<T_, Counting_>> {
+	size_t operator()(const cat::CompactSharedPtr<T_, Counting_>& v) const noexcept {
+		return std::hash<T_*>()(v.___getPtr());
+	}
+};
+
+template <class T_, class Counting_>
+struct std::hash<cat::ObserverPtr<T_, Counting_>> {
+	size_t operator()(const cat::ObserverPtr<T_, Counting_>& v) const noexcept {
 		return std::hash<T_*>()(v.___getPtr());
 	}
 };
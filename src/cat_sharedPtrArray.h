@@ -0,0 +1,231 @@
+#ifndef CAT_SHAREDPTRARRAY_H
+#define CAT_SHAREDPTRARRAY_H
+
+#include "cat_sharedPtr.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace cat {
+
+namespace _sharedPtr_internal {
+
+/**
+ * Copying or releasing many SharedPtrs one by one touches their control
+ * blocks in random memory order and stalls on each cache miss. The bulk
+ * operations prefetch the control block PREFETCH_DISTANCE elements ahead,
+ * merge the modifications of consecutive SharedPtrs that share a control
+ * block into one, and dispose the control blocks that dropped to zero in
+ * batches after the counting.
+ */
+struct SharedPtrBulk_ {
+	static constexpr size_t PREFETCH_DISTANCE = 16;
+	static constexpr size_t DISPOSE_BATCH_SIZE = 64;
+
+	template <class T_, class Counting_>
+	static void copy(const SharedPtr<T_, Counting_>* src, size_t count, SharedPtr<T_, Counting_>* out) noexcept {
+		using RefCnt = BasicSharedPtrRefCnt_<Counting_>;
+		RefCnt* run = nullptr;
+		typename Counting_::CntT runLength = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if (i + PREFETCH_DISTANCE < count) {
+				CAT_PREFETCH_WRITE(src[i + PREFETCH_DISTANCE]._ptrData.refCnt.___getPtr());
+			}
+			const auto& data = src[i]._ptrData;
+			RefCnt* refCnt = data.refCnt.___getPtr();
+			if (refCnt != run) {
+				if (run != nullptr) {
+					run->addUsageCnt(runLength);
+				}
+				run = refCnt;
+				runLength = 0;
+			}
+			++runLength;
+			out[i]._ptrData.adopt(data.refCnt, data.payload);
+		}
+		if (run != nullptr) {
+			run->addUsageCnt(runLength);
+		}
+	}
+
+	template <class T_, class Counting_>
+	static void release(SharedPtr<T_, Counting_>* ptrs, size_t count) {
+		using RefCnt = BasicSharedPtrRefCnt_<Counting_>;
+		RefCnt* disposable[DISPOSE_BATCH_SIZE];
+		size_t disposableCnt = 0;
+		const auto subtractRun = [&](RefCnt* run, typename Counting_::CntT runLength) {
+			if (run != nullptr and run->subtractUsageCnt(runLength)) {
+				disposable[disposableCnt++] = run;
+				if (disposableCnt == DISPOSE_BATCH_SIZE) {
+					_disposeAll(disposable, disposableCnt);
+					disposableCnt = 0;
+				}
+			}
+		};
+
+		RefCnt* run = nullptr;
+		typename Counting_::CntT runLength = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if (i + PREFETCH_DISTANCE < count) {
+				CAT_PREFETCH_WRITE(ptrs[i + PREFETCH_DISTANCE]._ptrData.refCnt.___getPtr());
+			}
+			auto& data = ptrs[i]._ptrData;
+			RefCnt* refCnt = data.refCnt.___getPtr();
+			data.refCnt = nullptr;
+			data.payload = nullptr;
+			if (refCnt != run) {
+				subtractRun(run, runLength);
+				run = refCnt;
+				runLength = 0;
+			}
+			++runLength;
+		}
+		subtractRun(run, runLength);
+		_disposeAll(disposable, disposableCnt);
+	}
+
+private:
+	template <class RefCnt_>
+	static void _disposeAll(RefCnt_** refCnts, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			refCnts[i]->dispose();
+		}
+	}
+};
+
+}
+
+
+/**
+ *  @brief  Copies count SharedPtrs from src to out, like a loop of copy
+ *  assignments, but see SharedPtrBulk_. out must hold null SharedPtrs and
+ *  must not overlap src.
+ *  Only adjacent SharedPtrs to the same control block are merged: {a, a, b}
+ *  modifies two counts, {a, b, a} three. Group src by control block first,
+ *  if it has many scattered duplicates.
+ */
+template <class T_, class Counting_>
+inline void copyShared(const SharedPtr<T_, Counting_>* src, size_t count, SharedPtr<T_, Counting_>* out) noexcept {
+	_sharedPtr_internal::SharedPtrBulk_::copy(src, count, out);
+}
+
+/**
+ *  @brief  Sets count SharedPtrs to nullptr, like a loop of reset()s, but
+ *  see SharedPtrBulk_. Like copyShared(), it only merges adjacent SharedPtrs
+ *  to the same control block.
+ */
+template <class T_, class Counting_>
+inline void releaseShared(SharedPtr<T_, Counting_>* ptrs, size_t count) {
+	_sharedPtr_internal::SharedPtrBulk_::release(ptrs, count);
+}
+
+
+/**
+ * A vector of SharedPtrs, that copies, clears and shrinks itself with
+ * copyShared() and releaseShared(). Useful for large snapshots, e.g. of a
+ * cache.
+ */
+template <class T_, class Counting_ = UnsyncedCounting>
+class SharedPtrArray {
+public:
+	using T = T_;
+	using Counting = Counting_;
+	using Value = SharedPtr<T, Counting>;
+	using iterator = Value*;
+	using const_iterator = const Value*;
+
+private:
+	std::vector<Value> _ptrs;
+
+public:
+	SharedPtrArray() noexcept = default;
+
+	explicit SharedPtrArray(size_t size)
+		: _ptrs(size, Value(nullptr))
+	{}
+
+	SharedPtrArray(const SharedPtrArray& other)
+		: _ptrs(other.size(), Value(nullptr))
+	{
+		copyShared(other.data(), other.size(), data());
+	}
+
+	SharedPtrArray(SharedPtrArray&& other) noexcept = default;
+
+	~SharedPtrArray() {
+		clear();
+	}
+
+	/**
+	 *  @brief  Keeps the capacity, like std::vector.
+	 */
+	SharedPtrArray& operator =(const SharedPtrArray& other) {
+		if (this != &other) {
+			clear();
+			_ptrs.resize(other.size(), Value(nullptr));
+			copyShared(other.data(), other.size(), data());
+		}
+		return *this;
+	}
+
+	SharedPtrArray& operator =(SharedPtrArray&& other) noexcept {
+		SharedPtrArray tmp(std::move(other));
+		tmp.swap(*this);
+		return *this;
+	}
+
+	inline void swap(SharedPtrArray& other) noexcept {
+		_ptrs.swap(other._ptrs);
+	}
+
+	void clear() {
+		releaseShared(_ptrs.data(), _ptrs.size());
+		_ptrs.clear();
+	}
+
+	/**
+	 *  @brief  New elements are null.
+	 */
+	void resize(size_t size) {
+		if (size < _ptrs.size()) {
+			releaseShared(_ptrs.data() + size, _ptrs.size() - size);
+		}
+		_ptrs.resize(size, Value(nullptr));
+	}
+
+	inline void reserve(size_t capacity) { _ptrs.reserve(capacity); }
+
+	/**
+	 *  @brief  Appends copies of count SharedPtrs, that must not be part of this array.
+	 */
+	void append(const Value* first, size_t count) {
+		const size_t oldSize = _ptrs.size();
+		_ptrs.resize(oldSize + count, Value(nullptr));
+		copyShared(first, count, _ptrs.data() + oldSize);
+	}
+
+	inline void push_back(const Value& value) { _ptrs.push_back(value); }
+	inline void push_back(Value&& value) { _ptrs.push_back(std::move(value)); }
+
+	inline size_t size() const noexcept { return _ptrs.size(); }
+	inline size_t capacity() const noexcept { return _ptrs.capacity(); }
+	inline bool empty() const noexcept { return _ptrs.empty(); }
+
+	inline Value* data() noexcept { return _ptrs.data(); }
+	inline const Value* data() const noexcept { return _ptrs.data(); }
+
+	inline Value& operator [](size_t index) noexcept { return _ptrs[index]; }
+	inline const Value& operator [](size_t index) const noexcept { return _ptrs[index]; }
+
+	inline iterator begin() noexcept { return _ptrs.data(); }
+	inline iterator end() noexcept { return _ptrs.data() + _ptrs.size(); }
+	inline const_iterator begin() const noexcept { return _ptrs.data(); }
+	inline const_iterator end() const noexcept { return _ptrs.data() + _ptrs.size(); }
+};
+
+}
+
+
+#endif // CAT_SHAREDPTRARRAY_H
@@ -0,0 +1,228 @@
+#ifndef CAT_SLABPOOL_H
+#define CAT_SLABPOOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace cat {
+
+/**
+ * Fallback for the opt-in below. A type opts in by declaring an overload
+ * of this function next to it (found through ADL), which is what
+ * CAT_POOLED_ALLOCATION(Cls) does. Types derived from an opted-in type are
+ * pooled as well.
+ */
+constexpr bool ___catUsePooledAllocation(const void*) noexcept { return false; }
+
+/**
+ * Decides whether the SharedPtr control blocks of T_ are allocated from a
+ * SlabPool instead of the global heap. May also be specialized directly.
+ */
+template <class T_>
+struct UsePooledAllocation: std::bool_constant<___catUsePooledAllocation(static_cast<const T_*>(nullptr))> {};
+
+template <class T_>
+inline constexpr bool usePooledAllocation_v = UsePooledAllocation<T_>::value;
+
+/**
+ * Opts Cls into pooled allocation of its SharedPtr control blocks. Use it in
+ * the namespace of Cls, e.g. right after PTRS_FOR_CLASS(Cls).
+ */
+#define CAT_POOLED_ALLOCATION(Cls) \
+	constexpr bool ___catUsePooledAllocation(const Cls*) noexcept { return true; }
+
+
+namespace _slabPool_internal {
+
+struct FreeNode_ {
+	FreeNode_* next;
+	FreeNode_* nextBatch;
+	size_t batchSize;
+};
+
+constexpr size_t maxOf(size_t a, size_t b) { return a < b ? b : a; }
+constexpr size_t roundUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+}
+
+/**
+ * SlabPool hands out fixed-size blocks. The blocks are carved out of large
+ * slabs, which are never returned to the system.
+ *
+ * Every thread keeps a free list of its own, so allocating and deallocating
+ * usually touches no shared state at all. A thread that frees many blocks
+ * hands them back to a global list in batches (under a mutex), from which
+ * other threads refill their free lists.
+ */
+template <size_t Size_, size_t Alignment_>
+class SlabPool {
+	using FreeNode_ = _slabPool_internal::FreeNode_;
+
+public:
+	static constexpr size_t BLOCK_ALIGNMENT = _slabPool_internal::maxOf(Alignment_, alignof(FreeNode_));
+	static constexpr size_t BLOCK_SIZE = _slabPool_internal::roundUp(_slabPool_internal::maxOf(Size_, sizeof(FreeNode_)), BLOCK_ALIGNMENT);
+	static constexpr size_t BATCH_SIZE = _slabPool_internal::maxOf(16, 4096 / BLOCK_SIZE);
+	static constexpr size_t BATCHES_PER_SLAB = 4;
+
+private:
+	struct Global_ {
+		std::mutex mutex;
+		FreeNode_* batches = nullptr;
+	};
+
+	/**
+	 * Trivially destructible on purpose, so it can still be used after the
+	 * thread-exit flush (e.g. from destructors of other thread_locals).
+	 */
+	struct Local_ {
+		FreeNode_* head;
+		size_t count;
+		bool hasFlusher;
+		bool isFlushed;
+	};
+
+	struct LocalFlusher_ {
+		~LocalFlusher_() {
+			Local_& local = _local();
+			if (local.head != nullptr) {
+				local.head->batchSize = local.count;
+				_pushBatch(local.head);
+			}
+			local.head = nullptr;
+			local.count = 0;
+			local.isFlushed = true;
+		}
+	};
+
+public:
+	static void* allocate() {
+		Local_& local = _local();
+		if (local.head == nullptr) {
+			if (local.isFlushed) {
+				// this thread is exiting. The block joins the pool once it is deallocated.
+				return ::operator new(BLOCK_SIZE, std::align_val_t(BLOCK_ALIGNMENT));
+			}
+			_refill(local);
+		}
+		FreeNode_* node = local.head;
+		local.head = node->next;
+		local.count -= 1;
+		return node;
+	}
+
+	static void deallocate(void* ptr) noexcept {
+		Local_& local = _local();
+		FreeNode_* node = static_cast<FreeNode_*>(ptr);
+		if (local.isFlushed) {
+			node->next = nullptr;
+			node->batchSize = 1;
+			_pushBatch(node);
+			return;
+		}
+		if (local.head == nullptr) {
+			_ensureFlusher(local);
+		}
+		node->next = local.head;
+		local.head = node;
+		local.count += 1;
+		if (local.count >= 2 * BATCH_SIZE) {
+			_flushBatch(local);
+		}
+	}
+
+private:
+	static Global_& _global() {
+		static Global_& global = *new Global_(); // never destroyed, blocks may outlive static destruction.
+		return global;
+	}
+
+	static Local_& _local() noexcept {
+		static thread_local Local_ local{nullptr, 0, false, false};
+		return local;
+	}
+
+	static void _pushBatch(FreeNode_* batch) noexcept {
+		Global_& global = _global();
+		std::lock_guard<std::mutex> lock(global.mutex);
+		batch->nextBatch = global.batches;
+		global.batches = batch;
+	}
+
+	/**
+	 * Keeps the BATCH_SIZE most recently freed (likely still cached) blocks and
+	 * hands the rest back.
+	 */
+	static void _flushBatch(Local_& local) noexcept {
+		FreeNode_* last = local.head;
+		for (size_t i = 1; i < BATCH_SIZE; ++i) {
+			last = last->next;
+		}
+		FreeNode_* batch = last->next;
+		last->next = nullptr;
+		batch->batchSize = local.count - BATCH_SIZE;
+		local.count = BATCH_SIZE;
+		_pushBatch(batch);
+	}
+
+	/**
+	 * Makes sure the blocks cached by this thread are handed back, when it exits.
+	 */
+	static void _ensureFlusher(Local_& local) noexcept {
+		if (not local.hasFlusher) {
+			static thread_local LocalFlusher_ flusher;
+			(void)flusher;
+			local.hasFlusher = true;
+		}
+	}
+
+	static void _refill(Local_& local) {
+		_ensureFlusher(local);
+
+		Global_& global = _global();
+		{
+			std::lock_guard<std::mutex> lock(global.mutex);
+			if (FreeNode_* batch = global.batches) {
+				global.batches = batch->nextBatch;
+				local.head = batch;
+				local.count = batch->batchSize;
+				return;
+			}
+		}
+
+		// carve a new slab. This thread keeps the first batch, the others go to the global list.
+		char* slab = static_cast<char*>(::operator new(BATCHES_PER_SLAB * BATCH_SIZE * BLOCK_SIZE, std::align_val_t(BLOCK_ALIGNMENT)));
+		FreeNode_* batches = nullptr;
+		for (size_t b = BATCHES_PER_SLAB; b > 0; --b) {
+			char* batchStart = slab + (b - 1) * BATCH_SIZE * BLOCK_SIZE;
+			FreeNode_* head = nullptr;
+			for (size_t i = BATCH_SIZE; i > 0; --i) {
+				FreeNode_* node = reinterpret_cast<FreeNode_*>(batchStart + (i - 1) * BLOCK_SIZE);
+				node->next = head;
+				head = node;
+			}
+			head->batchSize = BATCH_SIZE;
+			head->nextBatch = batches;
+			batches = head;
+		}
+		local.head = batches;
+		local.count = BATCH_SIZE;
+
+		FreeNode_* others = batches->nextBatch;
+		if (others != nullptr) {
+			FreeNode_* lastBatch = others;
+			while (lastBatch->nextBatch != nullptr) {
+				lastBatch = lastBatch->nextBatch;
+			}
+			std::lock_guard<std::mutex> lock(global.mutex);
+			lastBatch->nextBatch = global.batches;
+			global.batches = others;
+		}
+	}
+};
+
+}
+
+
+#endif // CAT_SLABPOOL_H
@@ -0,0 +1,249 @@
+#ifndef CAT_VALUEPTR_H
+#define CAT_VALUEPTR_H
+
+#include "cat_weakPtr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace cat {
+
+/**
+ * Owns one object of T or of a subclass of T like an OwningPtr, but has value
+ * semantics: copying a ValuePtr copies the object (with its real type).
+ * Objects of up to N_ bytes, that can be moved without throwing, are stored
+ * inside the ValuePtr itself, larger ones are allocated on the heap. e.g.:
+ *   std::vector<ValuePtr<Shape>> shapes;
+ *   shapes.push_back(ValuePtr<Shape>::make<Circle>(...)); // no allocation for the Circle.
+ *
+ * There is no need for a virtual destructor, the ValuePtr remembers how to
+ * destroy, copy and move the real type.
+ */
+template <class T_, size_t N_ = 48>
+class ValuePtr {
+public:
+	using T = T_;
+	static constexpr size_t INLINE_SIZE = N_;
+
+	/**
+	 *  @brief  Whether an object of T2_ would be stored inside the ValuePtr.
+	 */
+	template <class T2_>
+	static constexpr bool isInline_v = sizeof(T2_) <= N_ && alignof(T2_) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T2_>;
+
+private:
+	using MutableT = std::remove_const_t<T>;
+
+	/**
+	 * Knows the real type of the object.
+	 */
+	struct Ops_ {
+		void (*destroy)(MutableT* ptr, bool isInline) noexcept;
+		MutableT* (*clone)(const MutableT* ptr, void* buffer);
+		/**
+		 *  @brief  Moves an inline object into another buffer.
+		 */
+		MutableT* (*relocate)(MutableT* ptr, void* buffer) noexcept;
+	};
+
+	template <class T2_>
+	struct OpsFor_ {
+		static void destroy(MutableT* ptr, bool isInline) noexcept {
+			T2_* object = static_cast<T2_*>(ptr);
+			if (isInline) {
+				object->~T2_();
+			} else {
+				delete object;
+			}
+		}
+
+		static MutableT* clone(const MutableT* ptr, void* buffer) {
+			const T2_& object = *static_cast<const T2_*>(ptr);
+			if constexpr (isInline_v<T2_>) {
+				return new (buffer) T2_(object);
+			} else {
+				return new T2_(object);
+			}
+		}
+
+		static MutableT* relocate(MutableT* ptr, void* buffer) noexcept {
+			if constexpr (isInline_v<T2_>) {
+				T2_* object = static_cast<T2_*>(ptr);
+				T2_* result = new (buffer) T2_(std::move(*object));
+				object->~T2_();
+				return result;
+			} else {
+				return ptr; // never called, heap objects are just handed over.
+			}
+		}
+
+		static constexpr Ops_ OPS = { &destroy, &clone, &relocate };
+	};
+
+	alignas(std::max_align_t) std::byte _buffer[N_];
+	MutableT* _ptr;
+	const Ops_* _ops;
+
+public:
+	ValuePtr() noexcept : _ptr(nullptr), _ops(nullptr) {}
+	ValuePtr(std::nullptr_t) noexcept : ValuePtr() {}
+
+	template<class... Args_>
+	explicit ValuePtr(InplaceConstructorTag, Args_&&... args)
+		: ValuePtr()
+	{
+		_construct<MutableT>(std::forward<Args_>(args)...);
+	}
+
+	/**
+	 *  @brief  Constructs an object of T2_, a subclass of T.
+	 */
+	template<class T2_, class... Args_>
+	static ValuePtr make(Args_&&... args) {
+		static_assert(std::is_base_of_v<MutableT, T2_>, "T2_ must be T or a subclass of T.");
+		ValuePtr result;
+		result._construct<T2_>(std::forward<Args_>(args)...);
+		return result;
+	}
+
+	ValuePtr(const ValuePtr& other)
+		: ValuePtr()
+	{
+		if (other._ptr != nullptr) {
+			_ptr = other._ops->clone(other._ptr, _buffer);
+			_ops = other._ops;
+		}
+	}
+
+	ValuePtr(ValuePtr&& other) noexcept
+		: ValuePtr()
+	{
+		_takeOver(other);
+	}
+
+	~ValuePtr() {
+		reset();
+	}
+
+	ValuePtr& operator =(const ValuePtr& other) {
+		if (this != &other) {
+			ValuePtr tmp(other);
+			reset();
+			_takeOver(tmp);
+		}
+		return *this;
+	}
+
+	ValuePtr& operator =(ValuePtr&& other) noexcept {
+		if (this != &other) {
+			reset();
+			_takeOver(other);
+		}
+		return *this;
+	}
+
+	void reset() noexcept {
+		if (_ptr != nullptr) {
+			_ops->destroy(_ptr, isInline());
+			_ptr = nullptr;
+			_ops = nullptr;
+		}
+	}
+
+	/**
+	 *  @brief  Whether the object is stored inside this ValuePtr.
+	 */
+	inline bool isInline() const noexcept {
+		const auto address = reinterpret_cast<std::uintptr_t>(_ptr);
+		const auto buffer = reinterpret_cast<std::uintptr_t>(_buffer);
+		return address - buffer < N_;
+	}
+
+	WeakPtr<T> getWeak() {
+		return WeakPtr<T>(___getPtr());
+	}
+
+	WeakPtr<const T> getWeak() const {
+		return WeakPtr<const T>(___getPtr());
+	}
+
+	/**
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
+	 */
+	template<class T2_>
+	WeakPtr<T2_> as() const {
+		return WeakPtr<T2_>(kindCast<T2_>(___getPtr()));
+	}
+
+	/**
+	 *  @brief  Performs a static_cast<>().
+	 */
+	template<class T2_>
+	auto asStatic() const -> WeakPtr<T2_> {
+		return WeakPtr<T2_>(static_cast<T2_*>(___getPtr()));
+	}
+
+	inline T& operator *() noexcept { return *_ptr; }
+	inline const T& operator *() const noexcept { return *_ptr; }
+
+	inline T* operator ->() noexcept { return _ptr; }
+	inline const T* operator ->() const noexcept { return _ptr; }
+
+	inline bool operator ==(const ValuePtr& other) const noexcept { return _ptr == other._ptr; }
+	inline bool operator ==(std::nullptr_t) const noexcept { return _ptr == nullptr; }
+
+	inline bool operator !=(const ValuePtr& other) const noexcept { return _ptr != other._ptr; }
+	inline bool operator !=(std::nullptr_t) const noexcept { return _ptr != nullptr; }
+
+	explicit operator bool () const noexcept { return _ptr != nullptr; }
+
+	inline T* ___getPtr() noexcept {
+		return _ptr;
+	}
+
+	inline T* ___getPtr() const noexcept {
+		return _ptr;
+	}
+
+private:
+	template<class T2_, class... Args_>
+	void _construct(Args_&&... args) {
+		static_assert(std::is_copy_constructible_v<T2_>, "A ValuePtr copies its object, so it must be copy constructible.");
+		if constexpr (isInline_v<T2_>) {
+			_ptr = new (_buffer) T2_(std::forward<Args_>(args)...);
+		} else {
+			_ptr = new T2_(std::forward<Args_>(args)...);
+		}
+		_ops = &OpsFor_<T2_>::OPS;
+	}
+
+	/**
+	 *  @brief  this must be null.
+	 */
+	void _takeOver(ValuePtr& other) noexcept {
+		if (other._ptr == nullptr) {
+			return;
+		}
+		_ptr = other.isInline() ? other._ops->relocate(other._ptr, _buffer) : other._ptr;
+		_ops = other._ops;
+		other._ptr = nullptr;
+		other._ops = nullptr;
+	}
+};
+
+}
+
+template <class T_, size_t N_>
+struct std::hash<cat::ValuePtr<T_, N_>> {
+	size_t operator()(const cat::ValuePtr<T_, N_>& v) const noexcept {
+		return std::hash<T_*>()(v.___getPtr());
+	}
+};
+
+
+#endif // CAT_VALUEPTR_H
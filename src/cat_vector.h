@@ -0,0 +1,309 @@
+#ifndef CAT_VECTOR_H
+#define CAT_VECTOR_H
+
+#include "cat_weakPtr.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace cat {
+
+/**
+ * A std::vector-like container, that moves trivially relocatable elements
+ * (see IsTriviallyRelocatable) with memcpy()/memmove(): growing, inserting
+ * and erasing never call a move constructor or destructor of the elements
+ * that are only shifted around. That makes e.g. a
+ *   Vector<OwningPtr<TreeNode>> _children;
+ * grow and shrink as fast as a vector of raw pointers. Other elements are
+ * moved like in a std::vector.
+ */
+template <class T_>
+class Vector {
+public:
+	using T = T_;
+	using value_type = T;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	static constexpr bool IS_TRIVIALLY_RELOCATABLE = isTriviallyRelocatable_v<T>;
+
+private:
+	T* _data = nullptr;
+	size_t _size = 0;
+	size_t _capacity = 0;
+
+public:
+	Vector() noexcept = default;
+
+	/**
+	 *  @brief  Value-initializes size elements.
+	 */
+	explicit Vector(size_t size) {
+		resize(size);
+	}
+
+	Vector(const Vector& other)
+		: _data(_allocate(other._size)),
+		  _capacity(other._size)
+	{
+		try {
+			std::uninitialized_copy(other.begin(), other.end(), _data);
+		} catch (...) {
+			_deallocate(_data, _capacity);
+			throw;
+		}
+		_size = other._size;
+	}
+
+	Vector(Vector&& other) noexcept
+		: _data(other._data),
+		  _size(other._size),
+		  _capacity(other._capacity)
+	{
+		other._data = nullptr;
+		other._size = 0;
+		other._capacity = 0;
+	}
+
+	~Vector() {
+		clear();
+		_deallocate(_data, _capacity);
+	}
+
+	Vector& operator =(const Vector& other) {
+		if (this != &other) {
+			Vector tmp(other);
+			tmp.swap(*this);
+		}
+		return *this;
+	}
+
+	Vector& operator =(Vector&& other) noexcept {
+		Vector tmp(std::move(other));
+		tmp.swap(*this);
+		return *this;
+	}
+
+	inline void swap(Vector& other) noexcept {
+		std::swap(_data, other._data);
+		std::swap(_size, other._size);
+		std::swap(_capacity, other._capacity);
+	}
+
+	inline size_t size() const noexcept { return _size; }
+	inline size_t capacity() const noexcept { return _capacity; }
+	inline bool empty() const noexcept { return _size == 0; }
+
+	inline T* data() noexcept { return _data; }
+	inline const T* data() const noexcept { return _data; }
+
+	inline T& operator [](size_t index) noexcept { return _data[index]; }
+	inline const T& operator [](size_t index) const noexcept { return _data[index]; }
+
+	inline T& front() noexcept { return _data[0]; }
+	inline const T& front() const noexcept { return _data[0]; }
+	inline T& back() noexcept { return _data[_size - 1]; }
+	inline const T& back() const noexcept { return _data[_size - 1]; }
+
+	inline iterator begin() noexcept { return _data; }
+	inline iterator end() noexcept { return _data + _size; }
+	inline const_iterator begin() const noexcept { return _data; }
+	inline const_iterator end() const noexcept { return _data + _size; }
+
+	void reserve(size_t capacity) {
+		if (capacity > _capacity) {
+			_reallocate(capacity);
+		}
+	}
+
+	/**
+	 *  @brief  New elements are value-initialized.
+	 */
+	void resize(size_t size) {
+		if (size < _size) {
+			std::destroy(_data + size, _data + _size);
+			_size = size;
+			return;
+		}
+		reserve(size);
+		for (; _size < size; ++_size) {
+			new (_data + _size) T();
+		}
+	}
+
+	void clear() noexcept {
+		std::destroy(_data, _data + _size);
+		_size = 0;
+	}
+
+	inline void push_back(const T& value) { emplace_back(value); }
+	inline void push_back(T&& value) { emplace_back(std::move(value)); }
+
+	template <class... Args_>
+	T& emplace_back(Args_&&... args) {
+		if (_size < _capacity) {
+			new (_data + _size) T(std::forward<Args_>(args)...);
+		} else {
+			// construct the new element first, args may refer to an element of this vector.
+			const size_t newCapacity = _grownCapacity(_size + 1);
+			T* newData = _allocate(newCapacity);
+			try {
+				new (newData + _size) T(std::forward<Args_>(args)...);
+			} catch (...) {
+				_deallocate(newData, newCapacity);
+				throw;
+			}
+			try {
+				_relocateInto(newData, newCapacity, _size, 1);
+			} catch (...) {
+				std::destroy_at(newData + _size);
+				_deallocate(newData, newCapacity);
+				throw;
+			}
+		}
+		return _data[_size++];
+	}
+
+	inline void pop_back() noexcept {
+		std::destroy_at(_data + --_size);
+	}
+
+	inline iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+	inline iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+	template <class... Args_>
+	iterator emplace(const_iterator pos, Args_&&... args) {
+		const size_t index = static_cast<size_t>(pos - _data);
+		if (index == _size) {
+			emplace_back(std::forward<Args_>(args)...);
+			return _data + index;
+		}
+		if constexpr (IS_TRIVIALLY_RELOCATABLE) {
+			const size_t newCapacity = _size < _capacity ? _capacity : _grownCapacity(_size + 1);
+			T* newData = newCapacity != _capacity ? _allocate(newCapacity) : _data;
+			// construct the new element first, args may refer to an element of this vector.
+			alignas(T) std::byte element[sizeof(T)];
+			try {
+				new (element) T(std::forward<Args_>(args)...);
+			} catch (...) {
+				if (newData != _data) {
+					_deallocate(newData, newCapacity);
+				}
+				throw;
+			}
+			if (newData == _data) {
+				_memmove(_data + index + 1, _data + index, _size - index);
+			} else {
+				_relocateInto(newData, newCapacity, index, 1);
+			}
+			_memmove(_data + index, reinterpret_cast<T*>(element), 1);
+		} else {
+			T element(std::forward<Args_>(args)...);
+			emplace_back(std::move(back()));
+			std::move_backward(_data + index, _data + _size - 2, _data + _size - 1);
+			_data[index] = std::move(element);
+			return _data + index;
+		}
+		++_size;
+		return _data + index;
+	}
+
+	inline iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+	iterator erase(const_iterator first, const_iterator last) {
+		T* const begin = _data + (first - _data);
+		T* const end = _data + (last - _data);
+		const size_t count = static_cast<size_t>(end - begin);
+		if constexpr (IS_TRIVIALLY_RELOCATABLE) {
+			std::destroy(begin, end);
+			_memmove(begin, end, static_cast<size_t>(_data + _size - end));
+		} else {
+			std::move(end, _data + _size, begin);
+			std::destroy(_data + _size - count, _data + _size);
+		}
+		_size -= count;
+		return begin;
+	}
+
+private:
+	static T* _allocate(size_t capacity) {
+		if (capacity == 0) {
+			return nullptr;
+		}
+		return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+	}
+
+	static void _deallocate(T* data, size_t capacity) noexcept {
+		if (data != nullptr) {
+			::operator delete(data, capacity * sizeof(T), std::align_val_t(alignof(T)));
+		}
+	}
+
+	static inline void _memmove(T* dst, const T* src, size_t count) noexcept {
+		if (count != 0) {
+			std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+		}
+	}
+
+	inline size_t _grownCapacity(size_t minCapacity) const noexcept {
+		return std::max({minCapacity, _capacity * 2, size_t(4)});
+	}
+
+	void _reallocate(size_t capacity) {
+		T* newData = _allocate(capacity);
+		try {
+			_relocateInto(newData, capacity, _size, 0);
+		} catch (...) {
+			_deallocate(newData, capacity);
+			throw;
+		}
+	}
+
+	/**
+	 *  @brief  Moves all elements into newData and frees the old storage.
+	 *  Leaves a gap of gapSize elements at gapIndex. Never throws for
+	 *  trivially relocatable elements. Otherwise, if moving an element
+	 *  throws, newData is left empty and the caller has to free it. Like in
+	 *  a std::vector, elements that can't be copied are moved even if that
+	 *  may throw, and are left moved-from then.
+	 */
+	void _relocateInto(T* newData, size_t newCapacity, size_t gapIndex, size_t gapSize) {
+		if constexpr (IS_TRIVIALLY_RELOCATABLE) {
+			_memmove(newData, _data, gapIndex);
+			_memmove(newData + gapIndex + gapSize, _data + gapIndex, _size - gapIndex);
+		} else {
+			if constexpr (std::is_nothrow_move_constructible_v<T> || not std::is_copy_constructible_v<T>) {
+				std::uninitialized_move(_data, _data + gapIndex, newData);
+				try {
+					std::uninitialized_move(_data + gapIndex, _data + _size, newData + gapIndex + gapSize);
+				} catch (...) {
+					std::destroy(newData, newData + gapIndex);
+					throw;
+				}
+			} else {
+				std::uninitialized_copy(_data, _data + gapIndex, newData);
+				try {
+					std::uninitialized_copy(_data + gapIndex, _data + _size, newData + gapIndex + gapSize);
+				} catch (...) {
+					std::destroy(newData, newData + gapIndex);
+					throw;
+				}
+			}
+			std::destroy(_data, _data + _size);
+		}
+		_deallocate(_data, _capacity);
+		_data = newData;
+		_capacity = newCapacity;
+	}
+};
+
+}
+
+
+#endif // CAT_VECTOR_H
@@ -1,6 +1,9 @@
 #ifndef CAT_WEAKPTR_H
 #define CAT_WEAKPTR_H
 
+#include "cat_kindCast.h"
+
+#include <functional>
 #include <utility>
 #include <type_traits>
 
@@ -8,6 +11,19 @@ namespace cat {
 
 struct InplaceConstructorTag final {};
 
+/**
+ * Decides whether an object of T_ may be moved to another address with a
+ * plain memcpy(), without calling its move constructor and destructor (see
+ * cat::Vector). True for trivially copyable types. Specialized for the
+ * pointer types, because none of them refers to its own address. May be
+ * specialized for other types as well.
+ */
+template <class T_>
+struct IsTriviallyRelocatable: std::is_trivially_copyable<T_> {};
+
+template <class T_>
+inline constexpr bool isTriviallyRelocatable_v = IsTriviallyRelocatable<std::remove_cv_t<T_>>::value;
+
 template <class T_>
 struct WeakPtr {
 public:
@@ -23,34 +39,26 @@ public:
 	WeakPtr() noexcept : _ptr(nullptr) {}
 	WeakPtr(T* ptr) noexcept : _ptr(ptr) {}
 
-	WeakPtr(const WeakPtr& other) : _ptr(other._ptr) {}
-    WeakPtr(WeakPtr&& other) noexcept : _ptr(std::move(other._ptr)) {
-        other._ptr = nullptr;
-    }
+	/**
+	 *  @brief  Trivial, so a WeakPtr is passed in a register just like a T*.
+	 *  Moving doesn't null the source.
+	 */
+	WeakPtr(const WeakPtr& other) = default;
+	WeakPtr(WeakPtr&& other) = default;
 
 	template<class T2_, std::enable_if_t<std::is_base_of_v<T, T2_>, int> = 0>
-	explicit WeakPtr(WeakPtr<T2_>&& other) noexcept : _ptr(std::move(other.___getPtr())) {
-        other._ptr = nullptr;
-	}
+	explicit WeakPtr(WeakPtr<T2_>&& other) noexcept : _ptr(other._ptr) {}
 
-	~WeakPtr() { /* NOP() */ }
+	~WeakPtr() = default;
 
-    WeakPtr& operator =(const WeakPtr& other) {
-        _ptr = other._ptr;
-        return *this;
-    }
-    WeakPtr& operator =(WeakPtr&& other) noexcept {
-        _ptr = std::move(other._ptr);
-        other._ptr = nullptr;
-        return *this;
-    }
+	WeakPtr& operator =(const WeakPtr& other) = default;
+	WeakPtr& operator =(WeakPtr&& other) = default;
 
 	template<class T2_, std::enable_if_t<std::is_base_of_v<T, T2_>, int> = 0>
-    WeakPtr& operator =(WeakPtr<T2_>&& other) noexcept {
-        _ptr = std::move(other._ptr);
-        other._ptr = nullptr;
-        return *this;
-    }
+	WeakPtr& operator =(WeakPtr<T2_>&& other) noexcept {
+		_ptr = other._ptr;
+		return *this;
+	}
 
 public:
 	template<class T2_, std::enable_if_t<std::is_base_of_v<T2_, T>, int> = 0>
@@ -74,11 +82,11 @@ public:
 	}
 
 	/**
-	 *  @brief  Performs a dynamic_cast<>().
+	 *  @brief  Performs a dynamic_cast<>() (or just a kind check, see kindCast()).
 	 */
 	template<class T2_>
 	WeakPtr<T2_> as() const {
-		return WeakPtr<T2_>(dynamic_cast<T2_*>(_ptr));
+		return WeakPtr<T2_>(kindCast<T2_>(_ptr));
 	}
 
 	/**
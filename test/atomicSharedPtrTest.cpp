@@ -0,0 +1,176 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_atomicSharedPtr.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace cat;
+
+namespace {
+
+struct Table {
+	std::atomic<int>* cntr;
+	int version;
+	int checksum;
+
+	Table(std::atomic<int>* cntr, int version): cntr(cntr), version(version), checksum(-version) {}
+	~Table() { (*cntr)++; }
+};
+
+}
+
+class AtomicSharedPtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	AtomicSharedPtrTest() {}
+	~AtomicSharedPtrTest() {}
+
+	static constexpr int THREAD_CNT = 8;
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_sizeof() {
+		QCOMPARE(sizeof(AtomicSharedPtr<int>), sizeof(void*));
+		QVERIFY(AtomicSharedPtr<int>().is_lock_free());
+	}
+
+	void test_ctor() {
+		std::atomic<int> counter = 0;
+		{
+			AtomicSharedPtr<Table> slot1;
+			QVERIFY(slot1.load() == nullptr);
+			AtomicSharedPtr<Table> slot2{ConcurrentSharedPtr<Table>{{}, &counter, 1}};
+			QCOMPARE(slot2.load()->version, 1);
+		}
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_load() {
+		std::atomic<int> counter = 0;
+		ConcurrentSharedPtr<Table> table{{}, &counter, 1};
+		AtomicSharedPtr<Table> slot{table};
+		ConcurrentSharedPtr<Table> loaded = slot.load();
+		QVERIFY(loaded == table);
+		table = nullptr;
+		loaded = nullptr;
+		QCOMPARE(counter.load(), 0);
+		QCOMPARE(slot.load()->version, 1);
+	}
+
+	void test_store() {
+		std::atomic<int> counter = 0;
+		AtomicSharedPtr<const Table> slot;
+		slot.store(ConcurrentSharedPtr<const Table>{{}, &counter, 1});
+		ConcurrentSharedPtr<const Table> loaded = slot.load();
+		slot.store(ConcurrentSharedPtr<const Table>{{}, &counter, 2});
+		QCOMPARE(counter.load(), 0);
+		QCOMPARE(loaded->version, 1);
+		QCOMPARE(slot.load()->version, 2);
+		loaded = nullptr;
+		QCOMPARE(counter.load(), 1);
+		slot.store(nullptr);
+		QCOMPARE(counter.load(), 2);
+		QVERIFY(slot.load() == nullptr);
+	}
+
+	void test_exchange() {
+		std::atomic<int> counter = 0;
+		AtomicSharedPtr<Table> slot{ConcurrentSharedPtr<Table>{{}, &counter, 1}};
+		ConcurrentSharedPtr<Table> old = slot.exchange(ConcurrentSharedPtr<Table>{{}, &counter, 2});
+		QCOMPARE(old->version, 1);
+		QCOMPARE(slot.load()->version, 2);
+		old = slot.exchange(nullptr);
+		QCOMPARE(old->version, 2);
+		QCOMPARE(counter.load(), 1);
+		QVERIFY(slot.exchange(nullptr) == nullptr);
+	}
+
+	void test_compare_exchange() {
+		std::atomic<int> counter = 0;
+		ConcurrentSharedPtr<Table> table1{{}, &counter, 1};
+		ConcurrentSharedPtr<Table> table2{{}, &counter, 2};
+		AtomicSharedPtr<Table> slot{table1};
+
+		ConcurrentSharedPtr<Table> expected = table2;
+		QVERIFY(not slot.compare_exchange(expected, table2));
+		QVERIFY(expected == table1);
+		QVERIFY(slot.compare_exchange(expected, table2));
+		QVERIFY(expected == table1);
+		QVERIFY(slot.load() == table2);
+
+		expected = nullptr;
+		QVERIFY(not slot.compare_exchange(expected, nullptr));
+		QVERIFY(expected == table2);
+		QVERIFY(slot.compare_exchange(expected, nullptr));
+		expected = nullptr;
+		QVERIFY(slot.compare_exchange(expected, table1));
+		QVERIFY(slot.load() == table1);
+	}
+
+	void test_readers_and_writers() {
+		std::atomic<int> counter = 0;
+		constexpr int VERSIONS = 2000;
+		{
+			AtomicSharedPtr<const Table> slot{ConcurrentSharedPtr<const Table>{{}, &counter, 0}};
+			std::atomic<bool> done = false;
+			std::atomic<bool> corrupted = false;
+			std::vector<std::thread> threads;
+			for (int t = 0; t < THREAD_CNT; ++t) {
+				threads.emplace_back([&]() {
+					int lastVersion = 0;
+					while (not done.load()) {
+						ConcurrentSharedPtr<const Table> table = slot.load();
+						if (table->checksum != -table->version || table->version < lastVersion) {
+							corrupted = true;
+						}
+						lastVersion = table->version;
+					}
+				});
+			}
+			for (int version = 1; version <= VERSIONS; ++version) {
+				slot.store(ConcurrentSharedPtr<const Table>{{}, &counter, version});
+			}
+			done = true;
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			QVERIFY(not corrupted.load());
+			QCOMPARE(counter.load(), VERSIONS);
+		}
+		QCOMPARE(counter.load(), VERSIONS + 1);
+	}
+
+	void test_concurrent_compare_exchange() {
+		std::atomic<int> counter = 0;
+		constexpr int INCREMENTS = 500;
+		AtomicSharedPtr<const Table> slot{ConcurrentSharedPtr<const Table>{{}, &counter, 0}};
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREAD_CNT; ++t) {
+			threads.emplace_back([&]() {
+				for (int i = 0; i < INCREMENTS; ++i) {
+					ConcurrentSharedPtr<const Table> expected = slot.load();
+					while (not slot.compare_exchange(expected, ConcurrentSharedPtr<const Table>{{}, &counter, expected->version + 1})) {}
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		QCOMPARE(slot.load()->version, THREAD_CNT * INCREMENTS);
+	}
+
+};
+CAT_DECLARE_TEST(AtomicSharedPtrTest);
+
+
+
+#include "atomicSharedPtrTest.moc"
@@ -0,0 +1,194 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_biasedCounting.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace cat;
+using namespace cat::_sharedPtr_internal;
+
+namespace {
+
+struct BiasedMock {
+	std::atomic<int>* cntr;
+
+	BiasedMock(std::atomic<int>* cntr): cntr(cntr) {}
+	~BiasedMock() { (*cntr)++; }
+};
+
+template <class Fn_>
+void runOnThread(Fn_&& fn) {
+	std::thread thread(std::forward<Fn_>(fn));
+	thread.join();
+}
+
+}
+
+class BiasedCountingTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	BiasedCountingTest() {}
+	~BiasedCountingTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_owner_1() {
+		SharedPtrRefCntInplace_<int, BiasedCounting> obj{7, 0};
+		obj.incUsageCnt();
+		QCOMPARE(obj.getUsageCnt(), 8ull);
+		obj.decUsageCnt();
+		obj.decUsageCnt();
+		QCOMPARE(obj.getUsageCnt(), 6ull);
+	}
+
+	void test_owner_2() {
+		std::atomic<int> counter = 0;
+		{
+			BiasedSharedPtr<BiasedMock> shrPtr1{{}, &counter};
+			BiasedSharedPtr<BiasedMock> shrPtr2 = shrPtr1;
+			shrPtr1 = nullptr;
+			QCOMPARE(counter.load(), 0);
+		}
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_released_by_other_thread() {
+		std::atomic<int> counter = 0;
+		BiasedSharedPtr<BiasedMock> shrPtr{{}, &counter};
+		runOnThread([&]() {
+			BiasedSharedPtr<BiasedMock> copy1 = shrPtr;
+			BiasedSharedPtr<BiasedMock> copy2 = copy1;
+		});
+		QCOMPARE(counter.load(), 0);
+		shrPtr = nullptr;
+		// the biased count drained, while the shared count is zero:
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_merged_then_released_by_other_thread() {
+		std::atomic<int> counter = 0;
+		BiasedSharedPtr<BiasedMock> copy{nullptr};
+		{
+			BiasedSharedPtr<BiasedMock> shrPtr{{}, &counter};
+			runOnThread([&]() { copy = shrPtr; });
+		}
+		QCOMPARE(counter.load(), 0);
+		runOnThread([&]() { copy = nullptr; });
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_queued() {
+		std::atomic<int> counter = 0;
+		BiasedSharedPtr<BiasedMock> shrPtr{{}, &counter};
+		BiasedSharedPtr<BiasedMock> handedOut = shrPtr;
+		// releasing a reference of the owner makes the shared count negative:
+		runOnThread([handedOut = std::move(handedOut)]() mutable { handedOut = nullptr; });
+		QCOMPARE(counter.load(), 0);
+		BiasedCounting::mergeQueued();
+		QCOMPARE(counter.load(), 0);
+		shrPtr = nullptr;
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_queued_2() {
+		std::atomic<int> counter = 0;
+		BiasedSharedPtr<BiasedMock> shrPtr{{}, &counter};
+		BiasedSharedPtr<BiasedMock> handedOut = shrPtr;
+		runOnThread([handedOut = std::move(handedOut)]() mutable { handedOut = nullptr; });
+		shrPtr = nullptr;
+		// the biased count is still one, so only merging finds out, that the payload is unused:
+		QCOMPARE(counter.load(), 0);
+		BiasedCounting::mergeQueued();
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_owner_exited_1() {
+		std::atomic<int> counter = 0;
+		BiasedSharedPtr<BiasedMock> shrPtr{nullptr};
+		runOnThread([&]() { shrPtr = BiasedSharedPtr<BiasedMock>{{}, &counter}; });
+		QCOMPARE(counter.load(), 0);
+		BiasedSharedPtr<BiasedMock> copy = shrPtr;
+		shrPtr = nullptr;
+		QCOMPARE(counter.load(), 0);
+		copy = nullptr;
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_owner_exited_2() {
+		std::atomic<int> counter = 0;
+		BiasedSharedPtr<BiasedMock> shrPtr1{nullptr};
+		BiasedSharedPtr<BiasedMock> shrPtr2{nullptr};
+		runOnThread([&]() {
+			shrPtr1 = BiasedSharedPtr<BiasedMock>{{}, &counter};
+			shrPtr2 = shrPtr1;
+			runOnThread([&]() { shrPtr1 = nullptr; }); // queued at the owner
+		});
+		QCOMPARE(counter.load(), 0);
+		shrPtr2 = nullptr;
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_owner_exited_3() {
+		// control blocks created in thread_local destructors, after the owner has exited:
+		struct CreatesOnExit {
+			std::atomic<int>* counter = nullptr;
+			~CreatesOnExit() {
+				for (int i = 0; i < 4; ++i) {
+					BiasedSharedPtr<BiasedMock> shrPtr{{}, counter};
+					BiasedSharedPtr<BiasedMock> copy = shrPtr;
+				}
+			}
+		};
+		std::atomic<int> counter = 0;
+		runOnThread([&]() {
+			static thread_local CreatesOnExit createsOnExit; // destroyed after the owner closed.
+			createsOnExit.counter = &counter;
+			BiasedSharedPtr<BiasedMock> shrPtr{{}, &counter};
+		});
+		QCOMPARE(counter.load(), 5);
+	}
+
+	void test_threads() {
+		constexpr int THREAD_CNT = 8;
+		constexpr int ITERATIONS = 20000;
+		std::atomic<int> counter = 0;
+		{
+			BiasedSharedPtr<BiasedMock> shrPtr{{}, &counter};
+			std::vector<std::thread> threads;
+			for (int t = 0; t < THREAD_CNT; ++t) {
+				threads.emplace_back([handedOut = shrPtr]() mutable {
+					for (int i = 0; i < ITERATIONS; ++i) {
+						BiasedSharedPtr<BiasedMock> copy = handedOut;
+						BiasedSharedPtr<BiasedMock> local{{}, copy->cntr};
+					}
+					handedOut = nullptr;
+				});
+			}
+			for (int i = 0; i < ITERATIONS; ++i) {
+				BiasedSharedPtr<BiasedMock> copy = shrPtr;
+				BiasedCounting::mergeQueued();
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			QCOMPARE(counter.load(), THREAD_CNT * ITERATIONS);
+		}
+		BiasedCounting::mergeQueued();
+		QCOMPARE(counter.load(), THREAD_CNT * ITERATIONS + 1);
+	}
+
+};
+CAT_DECLARE_TEST(BiasedCountingTest);
+
+
+
+#include "biasedCountingTest.moc"
@@ -0,0 +1,52 @@
+#!/bin/sh
+# Compiles pointerCodegen.cpp to assembly and checks, that every function
+# cat_codegen_<name>_cat has the same instructions as cat_codegen_<name>_ref.
+# The order of the instructions is ignored, because it differs between
+# standard libraries (e.g. when the source of a moved std::unique_ptr is
+# nulled). Needs GCC or Clang on an ELF platform.
+#
+# usage: checkCodegen.sh [compiler] [extra compiler flags...]
+
+set -eu
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+CXX=${1:-c++}
+if [ $# -gt 0 ]; then
+	shift
+fi
+
+ASM=$(mktemp)
+trap 'rm -f "$ASM"' EXIT
+
+"$CXX" -std=c++17 -O2 -S -fno-asynchronous-unwind-tables -I"$HERE/../../src" "$@" -o "$ASM" "$HERE/pointerCodegen.cpp"
+
+# prints the sorted instructions of function $1 without directives, with the
+# _cat/_ref suffix of called functions and the numbers of local labels removed.
+body() {
+	awk -v name="$1" '
+		$0 == name ":" { inside = 1; next }
+		inside && /^[ \t]*\.size/ { exit }
+		inside && /^[ \t]*\./ { next }
+		inside { print }
+	' "$ASM" | sed -e 's/\(cat_codegen_[A-Za-z]*\)_\(cat\|ref\)/\1/g' -e 's/\.L[A-Za-z_]*[0-9]*/.L/g' | LC_ALL=C sort
+}
+
+FAILED=0
+CHECKED=0
+for name in $(grep -o '^cat_codegen_[A-Za-z]*_cat:' "$ASM" | sed -e 's/_cat:$//'); do
+	CHECKED=$((CHECKED + 1))
+	if [ "$(body "${name}_cat")" = "$(body "${name}_ref")" ]; then
+		echo "PASS   : $name"
+	else
+		echo "FAIL!  : $name"
+		echo "--- cat:"; body "${name}_cat"
+		echo "--- ref:"; body "${name}_ref"
+		FAILED=1
+	fi
+done
+
+if [ "$CHECKED" -eq 0 ]; then
+	echo "FAIL!  : no cat_codegen_*_cat functions found"
+	exit 1
+fi
+exit $FAILED
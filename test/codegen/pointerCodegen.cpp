@@ -0,0 +1,76 @@
+/**
+ * Compiled to assembly by checkCodegen.sh. Every function cat_codegen_<name>_cat
+ * must compile to the same instructions as its twin cat_codegen_<name>_ref,
+ * which uses a raw pointer or a std::unique_ptr instead.
+ */
+#include "cat_owningPtr.h"
+#include "cat_weakPtr.h"
+
+#include <memory>
+#include <new>
+#include <type_traits>
+
+using namespace cat;
+
+// not in an anonymous namespace, so the functions below are emitted.
+struct Node {
+	int value;
+};
+
+static_assert(std::is_trivially_copyable_v<WeakPtr<Node>>);
+static_assert(std::is_trivially_copy_constructible_v<WeakPtr<Node>>);
+static_assert(std::is_trivially_move_constructible_v<WeakPtr<Node>>);
+static_assert(std::is_trivially_copy_assignable_v<WeakPtr<Node>>);
+static_assert(std::is_trivially_move_assignable_v<WeakPtr<Node>>);
+static_assert(std::is_trivially_destructible_v<WeakPtr<Node>>);
+static_assert(std::is_trivially_copyable_v<WeakPtr<const Node>>);
+static_assert(sizeof(WeakPtr<Node>) == sizeof(Node*));
+static_assert(alignof(WeakPtr<Node>) == alignof(Node*));
+
+static_assert(sizeof(OwningPtr<Node>) == sizeof(Node*));
+static_assert(std::is_nothrow_move_constructible_v<OwningPtr<Node>>);
+static_assert(std::is_nothrow_move_assignable_v<OwningPtr<Node>>);
+static_assert(not std::is_copy_constructible_v<OwningPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<WeakPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<OwningPtr<Node>>);
+
+
+// opaque, so the calls can't be optimized away:
+void sinkCat(WeakPtr<Node> ptr) asm("cat_codegen_sink_cat");
+void sinkRef(Node* ptr) asm("cat_codegen_sink_ref");
+
+
+// passing by value:
+void passCat(WeakPtr<Node> ptr) asm("cat_codegen_pass_cat");
+void passCat(WeakPtr<Node> ptr) { sinkCat(ptr); }
+void passRef(Node* ptr) asm("cat_codegen_pass_ref");
+void passRef(Node* ptr) { sinkRef(ptr); }
+
+// returning by value:
+WeakPtr<Node> returnCat(Node* ptr) asm("cat_codegen_return_cat");
+WeakPtr<Node> returnCat(Node* ptr) { return ptr; }
+Node* returnRef(Node* ptr) asm("cat_codegen_return_ref");
+Node* returnRef(Node* ptr) { return ptr; }
+
+// dereferencing:
+int derefCat(WeakPtr<Node> ptr) asm("cat_codegen_deref_cat");
+int derefCat(WeakPtr<Node> ptr) { return ptr->value; }
+int derefRef(Node* ptr) asm("cat_codegen_deref_ref");
+int derefRef(Node* ptr) { return ptr->value; }
+
+// moving:
+void moveCat(WeakPtr<Node>& dst, WeakPtr<Node>& src) asm("cat_codegen_move_cat");
+void moveCat(WeakPtr<Node>& dst, WeakPtr<Node>& src) { dst = std::move(src); }
+void moveRef(Node*& dst, Node*& src) asm("cat_codegen_move_ref");
+void moveRef(Node*& dst, Node*& src) { dst = std::move(src); }
+
+// moving an OwningPtr costs the same as moving a std::unique_ptr:
+void moveConstructOwningCat(void* storage, OwningPtr<Node>& src) asm("cat_codegen_moveConstructOwning_cat");
+void moveConstructOwningCat(void* storage, OwningPtr<Node>& src) { new (storage) OwningPtr<Node>(std::move(src)); }
+void moveConstructOwningRef(void* storage, std::unique_ptr<Node>& src) asm("cat_codegen_moveConstructOwning_ref");
+void moveConstructOwningRef(void* storage, std::unique_ptr<Node>& src) { new (storage) std::unique_ptr<Node>(std::move(src)); }
+
+void moveAssignOwningCat(OwningPtr<Node>& dst, OwningPtr<Node>& src) asm("cat_codegen_moveAssignOwning_cat");
+void moveAssignOwningCat(OwningPtr<Node>& dst, OwningPtr<Node>& src) { dst = std::move(src); }
+void moveAssignOwningRef(std::unique_ptr<Node>& dst, std::unique_ptr<Node>& src) asm("cat_codegen_moveAssignOwning_ref");
+void moveAssignOwningRef(std::unique_ptr<Node>& dst, std::unique_ptr<Node>& src) { dst = std::move(src); }
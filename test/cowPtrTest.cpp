@@ -0,0 +1,168 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_biasedCounting.h"
+#include "cat_cowPtr.h"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cat;
+
+static_assert(UnsyncedCounting::IS_LOAD_EXACT);
+static_assert(AtomicCounting::IS_LOAD_EXACT);
+static_assert(ObservableCounting<AtomicCounting>::IS_LOAD_EXACT);
+// off its owner thread, the load() of a BiasedCounting misses the biased count:
+static_assert(not BiasedCounting::IS_LOAD_EXACT);
+
+namespace {
+
+struct Document {
+	static inline int copyCnt = 0;
+
+	std::string title;
+	std::vector<int> lines;
+
+	Document(std::string title, std::vector<int> lines): title(std::move(title)), lines(std::move(lines)) {}
+	Document(const Document& other): title(other.title), lines(other.lines) { copyCnt++; }
+};
+
+}
+
+class CowPtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	CowPtrTest() {}
+	~CowPtrTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_ctor() {
+		CowPtr<Document> doc{{}, "a", std::vector<int>{1, 2, 3}};
+		QVERIFY(doc != nullptr);
+		QCOMPARE(doc->title, std::string("a"));
+		QCOMPARE((*doc).lines.size(), size_t(3));
+		QVERIFY(doc.isUnique());
+
+		CowPtr<Document> null = nullptr;
+		QVERIFY(null == nullptr);
+		QVERIFY(not null.isUnique());
+		null.makeUnique();
+		QVERIFY(null == nullptr);
+	}
+
+	void test_copy_shares() {
+		Document::copyCnt = 0;
+		CowPtr<Document> doc{{}, "a", std::vector<int>{1, 2, 3}};
+		CowPtr<Document> copy = doc;
+		QVERIFY(copy == doc);
+		QCOMPARE(copy.___getPtr(), doc.___getPtr());
+		QVERIFY(not doc.isUnique());
+		QVERIFY(not copy.isUnique());
+		QCOMPARE(Document::copyCnt, 0);
+	}
+
+	void test_getMutable_copiesShared() {
+		Document::copyCnt = 0;
+		CowPtr<Document> doc{{}, "a", std::vector<int>{1, 2, 3}};
+		CowPtr<Document> copy = doc;
+		const Document* original = doc.___getPtr();
+
+		copy.getMutable().title = "b";
+		QCOMPARE(Document::copyCnt, 1);
+		QVERIFY(copy != doc);
+		QCOMPARE(doc.___getPtr(), original);
+		QCOMPARE(doc->title, std::string("a"));
+		QCOMPARE(copy->title, std::string("b"));
+		QVERIFY(doc.isUnique());
+		QVERIFY(copy.isUnique());
+
+		copy.getMutable().lines.push_back(4);
+		doc.getMutable().lines.clear();
+		QCOMPARE(Document::copyCnt, 1); // both are unique now.
+		QCOMPARE(copy->lines.size(), size_t(4));
+		QVERIFY(doc->lines.empty());
+	}
+
+	void test_makeUnique() {
+		Document::copyCnt = 0;
+		CowPtr<Document> doc{{}, "a", std::vector<int>{}};
+		doc.makeUnique();
+		QCOMPARE(Document::copyCnt, 0);
+		{
+			CowPtr<Document> copy = doc;
+			doc.makeUnique();
+			QCOMPARE(Document::copyCnt, 1);
+			QVERIFY(copy.isUnique());
+		}
+		QVERIFY(doc.isUnique());
+	}
+
+	void test_fromSharedPtr() {
+		Document::copyCnt = 0;
+		SharedPtr<Document> shared{{}, "a", std::vector<int>{}};
+		CowPtr<Document> doc{shared};
+		QVERIFY(not doc.isUnique());
+		shared = nullptr;
+		QVERIFY(doc.isUnique());
+		doc.getMutable().title = "b";
+		QCOMPARE(Document::copyCnt, 0);
+	}
+
+	void test_observed() {
+		SharedPtr<Document, ObservableCounting<>> shared{{}, "a", std::vector<int>{}};
+		ObserverPtr<Document> observer = shared;
+		CowPtr<Document, ObservableCounting<>> doc{std::move(shared)};
+		QVERIFY(not doc.isUnique()); // the observer could lock() it.
+		Document::copyCnt = 0;
+		doc.getMutable().title = "b";
+		QCOMPARE(Document::copyCnt, 1);
+		QVERIFY(observer.lock() == nullptr); // the original was released, not modified.
+	}
+
+	void test_concurrent() {
+		ConcurrentCowPtr<Document> doc{{}, "a", std::vector<int>{}};
+		ConcurrentCowPtr<Document> copy = doc;
+		QVERIFY(not doc.isUnique());
+		Document::copyCnt = 0;
+		copy.getMutable().title = "b";
+		QCOMPARE(Document::copyCnt, 1);
+		QVERIFY(doc.isUnique());
+	}
+
+	void test_concurrent_observerLocks() {
+		for (int i = 0; i < 500; ++i) {
+			ConcurrentObservableSharedPtr<int> shared{{}, 0};
+			std::optional<ConcurrentObserverPtr<int>> observer{std::in_place, shared};
+			CowPtr<int, ObservableCounting<AtomicCounting>> doc{std::move(shared)};
+			bool isChanged = false;
+			std::thread reader([&observer, &isChanged]() {
+				ConcurrentObservableSharedPtr<int> locked = observer->lock();
+				observer.reset(); // weak 2 -> 1, while the usage count is still 2.
+				if (locked != nullptr) {
+					const int before = *locked;
+					std::this_thread::yield();
+					isChanged = *locked != before;
+				}
+			});
+			doc.getMutable() = 1; // must copy, if the reader holds the payload.
+			reader.join();
+			QVERIFY(not isChanged);
+			QCOMPARE(*doc, 1);
+		}
+	}
+
+};
+CAT_DECLARE_TEST(CowPtrTest);
+
+
+
+#include "cowPtrTest.moc"
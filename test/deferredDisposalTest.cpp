@@ -0,0 +1,212 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_sharedPtr.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace cat;
+
+namespace {
+
+struct DeferredMock {
+	std::atomic<int>* cntr;
+	SharedPtr<DeferredMock> next = nullptr;
+
+	DeferredMock(std::atomic<int>* cntr): cntr(cntr) {}
+	DeferredMock(std::atomic<int>* cntr, SharedPtr<DeferredMock> next): cntr(cntr), next(std::move(next)) {}
+	virtual ~DeferredMock() { (*cntr)++; }
+};
+CAT_DEFERRED_DISPOSAL(DeferredMock)
+
+struct DeferredMockDerived: DeferredMock {
+	using DeferredMock::DeferredMock;
+};
+
+struct ImmediateMock {
+	std::atomic<int>* cntr;
+
+	ImmediateMock(std::atomic<int>* cntr): cntr(cntr) {}
+	~ImmediateMock() { (*cntr)++; }
+};
+
+}
+
+class DeferredDisposalTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	DeferredDisposalTest() {}
+	~DeferredDisposalTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void init() { reclaim(); }
+
+	void test_traits() {
+		QVERIFY(useDeferredDisposal_v<DeferredMock>);
+		QVERIFY(useDeferredDisposal_v<const DeferredMock>);
+		QVERIFY(useDeferredDisposal_v<DeferredMockDerived>);
+		QVERIFY(not useDeferredDisposal_v<ImmediateMock>);
+		QVERIFY(not useDeferredDisposal_v<int>);
+	}
+
+	void test_deferred() {
+		std::atomic<int> counter = 0;
+		{
+			SharedPtr<DeferredMock> shrPtr{{}, &counter};
+			SharedPtr<const DeferredMock> shrPtr2 = shrPtr;
+		}
+		QCOMPARE(counter.load(), 0);
+		QCOMPARE(reclaim(), 1ul);
+		QCOMPARE(counter.load(), 1);
+		QCOMPARE(reclaim(), 0ul);
+	}
+
+	void test_deferred_derived() {
+		std::atomic<int> counter = 0;
+		{
+			SharedPtr<DeferredMock> shrPtr = SharedPtr<DeferredMockDerived>{{}, &counter};
+		}
+		QCOMPARE(counter.load(), 0);
+		reclaim();
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_immediate() {
+		std::atomic<int> counter = 0;
+		{
+			SharedPtr<ImmediateMock> shrPtr{{}, &counter};
+		}
+		QCOMPARE(counter.load(), 1);
+		QCOMPARE(reclaim(), 0ul);
+	}
+
+	void test_chain() {
+		constexpr int LENGTH = 1000;
+		std::atomic<int> counter = 0;
+		{
+			SharedPtr<DeferredMock> head{nullptr};
+			for (int i = 0; i < LENGTH; ++i) {
+				head = SharedPtr<DeferredMock>{{}, &counter, std::move(head)};
+			}
+		}
+		QCOMPARE(counter.load(), 0);
+		// the released successors are deferred as well and disposed by the same call:
+		QCOMPARE(reclaim(), size_t(LENGTH));
+		QCOMPARE(counter.load(), LENGTH);
+	}
+
+	void test_observer() {
+		std::atomic<int> counter = 0;
+		ObserverPtr<DeferredMock> observer{nullptr};
+		{
+			ObservableSharedPtr<DeferredMock> shrPtr{{}, &counter};
+			observer = shrPtr;
+		}
+		QVERIFY(observer.expired());
+		QVERIFY(observer.lock() == nullptr);
+		QCOMPARE(counter.load(), 0);
+		reclaim();
+		QCOMPARE(counter.load(), 1);
+		observer = nullptr;
+
+		{
+			ObservableSharedPtr<DeferredMock> shrPtr{{}, &counter};
+			observer = shrPtr;
+		}
+		reclaim();
+		QCOMPARE(counter.load(), 2);
+		observer = nullptr; // frees the control block right away.
+		QCOMPARE(reclaim(), 0ul);
+	}
+
+	void test_stats() {
+		std::atomic<int> counter = 0;
+		const DeferredDisposalStats before = DeferredDisposal::stats();
+		QCOMPARE(before.pending, 0ul);
+		for (int i = 0; i < 3; ++i) {
+			SharedPtr<DeferredMock> shrPtr{{}, &counter};
+		}
+		QCOMPARE(DeferredDisposal::stats().pending, 3ul);
+		reclaim();
+		const DeferredDisposalStats after = DeferredDisposal::stats();
+		QCOMPARE(after.pending, 0ul);
+		QCOMPARE(after.reclaimed - before.reclaimed, 3ul);
+		QCOMPARE(after.batches - before.batches, 1ul);
+		QCOMPARE(after.lastBatchSize, 3ul);
+		QVERIFY(after.maxBatchSize >= 3);
+	}
+
+	void test_released_by_other_thread() {
+		std::atomic<int> counter = 0;
+		SharedPtr<DeferredMock> shrPtr{{}, &counter};
+		// the thread publishes its buffer, when it exits:
+		std::thread thread([shrPtr = std::move(shrPtr)]() mutable { shrPtr = nullptr; });
+		thread.join();
+		QCOMPARE(counter.load(), 0);
+		reclaim();
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_flush() {
+		std::atomic<int> counter = 0;
+		{
+			SharedPtr<DeferredMock> shrPtr{{}, &counter};
+		}
+		DeferredDisposal::flush();
+		std::thread thread([]() { reclaim(); });
+		thread.join();
+		QCOMPARE(counter.load(), 1);
+	}
+
+	void test_background_reclaimer() {
+		std::atomic<int> counter = 0;
+		BackgroundReclaimer reclaimer;
+		std::thread thread([&counter]() {
+			for (int i = 0; i < 1000; ++i) {
+				ConcurrentSharedPtr<DeferredMock> shrPtr{{}, &counter};
+			}
+		});
+		thread.join();
+		for (int i = 0; i < 1000 && counter.load() != 1000; ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		QCOMPARE(counter.load(), 1000);
+	}
+
+	void test_background_reclaimer_partial_batch() {
+		std::atomic<int> counter = 0;
+		std::atomic<bool> isDone = false;
+		BackgroundReclaimer reclaimer;
+		// the thread stays alive and never fills a batch, so it never publishes one itself:
+		std::thread thread([&counter, &isDone]() {
+			for (int i = 0; i < 10; ++i) {
+				ConcurrentSharedPtr<DeferredMock> shrPtr{{}, &counter};
+			}
+			while (not isDone.load()) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+		for (int i = 0; i < 1000 && counter.load() != 10; ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		const int reclaimedWhileAlive = counter.load();
+		isDone = true;
+		thread.join();
+		QCOMPARE(reclaimedWhileAlive, 10);
+	}
+
+};
+CAT_DECLARE_TEST(DeferredDisposalTest);
+
+
+
+#include "deferredDisposalTest.moc"
@@ -0,0 +1,153 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_destroyTree.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace cat;
+
+namespace {
+
+struct TreeMock {
+	std::atomic<int>* cntr;
+	std::vector<OwningPtr<TreeMock>> children;
+
+	TreeMock(std::atomic<int>* cntr): cntr(cntr) {}
+	~TreeMock() {
+		for (const auto& child : children) {
+			if (child != nullptr) {
+				(*cntr) -= 1000000; // children must have been detached.
+			}
+		}
+		(*cntr)++;
+	}
+
+	template <class Fn_>
+	void detachChildren(Fn_&& fn) {
+		for (auto& child : children) {
+			fn(std::move(child));
+		}
+	}
+};
+
+/**
+ * No detachChildren() member, TreeChildren is specialized below.
+ */
+struct BinaryTreeMock {
+	std::atomic<int>* cntr;
+	OwningPtr<BinaryTreeMock> left;
+	OwningPtr<BinaryTreeMock> right;
+
+	BinaryTreeMock(std::atomic<int>* cntr): cntr(cntr) {}
+	~BinaryTreeMock() { (*cntr)++; }
+};
+
+OwningPtr<TreeMock> makeChain(std::atomic<int>* cntr, int length) {
+	OwningPtr<TreeMock> root{{}, cntr};
+	TreeMock* last = root.___getPtr();
+	for (int i = 1; i < length; ++i) {
+		last->children.emplace_back(InplaceConstructorTag{}, cntr);
+		last = last->children.back().___getPtr();
+	}
+	return root;
+}
+
+OwningPtr<TreeMock> makeTree(std::atomic<int>* cntr, int depth, int width) {
+	OwningPtr<TreeMock> node{{}, cntr};
+	if (depth > 1) {
+		for (int i = 0; i < width; ++i) {
+			node->children.push_back(makeTree(cntr, depth - 1, width));
+		}
+	}
+	return node;
+}
+
+}
+
+template <>
+struct cat::TreeChildren<BinaryTreeMock> {
+	template <class Fn_>
+	static void detach(BinaryTreeMock& node, Fn_&& fn) {
+		fn(std::move(node.left));
+		fn(std::move(node.right));
+	}
+};
+
+
+class DestroyTreeTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	DestroyTreeTest() {}
+	~DestroyTreeTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_nullptr() {
+		destroyTree(OwningPtr<TreeMock>{nullptr});
+		destroyTreeParallel(OwningPtr<TreeMock>{nullptr}, 4);
+	}
+
+	void test_deep_chain() {
+		constexpr int LENGTH = 1000000; // would overflow the stack, if it was destroyed recursively.
+		std::atomic<int> counter = 0;
+		OwningPtr<TreeMock> root = makeChain(&counter, LENGTH);
+		destroyTree(std::move(root));
+		QVERIFY(root == nullptr);
+		QCOMPARE(counter.load(), LENGTH);
+	}
+
+	void test_tree() {
+		std::atomic<int> counter = 0;
+		destroyTree(makeTree(&counter, 5, 4));
+		QCOMPARE(counter.load(), 1 + 4 + 16 + 64 + 256);
+	}
+
+	void test_trait() {
+		std::atomic<int> counter = 0;
+		OwningPtr<BinaryTreeMock> root{{}, &counter};
+		root->left = OwningPtr<BinaryTreeMock>{{}, &counter};
+		root->left->right = OwningPtr<BinaryTreeMock>{{}, &counter};
+		root->right = OwningPtr<BinaryTreeMock>{{}, &counter};
+		destroyTree(std::move(root));
+		QCOMPARE(counter.load(), 4);
+	}
+
+	void test_parallel_tree() {
+		std::atomic<int> counter = 0;
+		destroyTreeParallel(makeTree(&counter, 6, 5), 4);
+		QCOMPARE(counter.load(), 1 + 5 + 25 + 125 + 625 + 3125);
+	}
+
+	void test_parallel_small_tree() {
+		std::atomic<int> counter = 0;
+		destroyTreeParallel(makeTree(&counter, 2, 3), 4);
+		QCOMPARE(counter.load(), 4);
+	}
+
+	void test_parallel_deep_chain() {
+		constexpr int LENGTH = 100000;
+		std::atomic<int> counter = 0;
+		destroyTreeParallel(makeChain(&counter, LENGTH), 4);
+		QCOMPARE(counter.load(), LENGTH);
+	}
+
+	void test_parallel_single_thread() {
+		std::atomic<int> counter = 0;
+		destroyTreeParallel(makeTree(&counter, 3, 3), 1);
+		QCOMPARE(counter.load(), 13);
+	}
+
+};
+CAT_DECLARE_TEST(DestroyTreeTest);
+
+
+
+#include "destroyTreeTest.moc"
@@ -0,0 +1,239 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "catPointers.h"
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace cat;
+
+namespace {
+
+PTRS_FOR_STRUCT(IntrusiveMock)
+struct IntrusiveMock: IntrusiveRefCnt<IntrusiveMock> {
+	int* cntr;
+
+	IntrusiveMock(int* cntr): cntr(cntr) {}
+	virtual ~IntrusiveMock() { (*cntr)++; }
+
+	IntrusiveMockIntrusivePtr self() { return IntrusiveMockIntrusivePtr(this); }
+	IntrusiveMockCIntrusivePtr self() const { return IntrusiveMockCIntrusivePtr(this); }
+};
+
+struct IntrusiveMockDerived: IntrusiveMock {
+	int value;
+
+	IntrusiveMockDerived(int* cntr, int value): IntrusiveMock(cntr), value(value) {}
+};
+
+struct IntrusivePos: IntrusiveRefCnt<IntrusivePos> {
+	int x, y;
+};
+
+struct ConcurrentIntrusiveMock: IntrusiveRefCnt<ConcurrentIntrusiveMock, AtomicCounting> {
+	std::atomic<int>* cntr;
+
+	ConcurrentIntrusiveMock(std::atomic<int>* cntr): cntr(cntr) {}
+	~ConcurrentIntrusiveMock() { (*cntr)++; }
+};
+
+}
+
+class IntrusivePtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	IntrusivePtrTest() {}
+	~IntrusivePtrTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_sizeof() {
+		QCOMPARE(sizeof(IntrusivePtr<IntrusiveMock>), sizeof(void*));
+		QCOMPARE(sizeof(IntrusiveRefCnt<int>), sizeof(size_t));
+	}
+
+	void test_ctor_1() {
+		int counter = 0;
+		{
+			IntrusivePtr<IntrusiveMock> ptr{{}, &counter};
+			QCOMPARE(ptr->getUsageCnt(), 1ull);
+			QCOMPARE(counter, 0);
+		}
+		QCOMPARE(counter, 1);
+	}
+
+	void test_ctor_2() {
+		IntrusivePtr<IntrusiveMock> ptr{nullptr};
+		QVERIFY(ptr == nullptr);
+		QVERIFY(not ptr);
+	}
+
+	void test_ctor_3() {
+		int counter = 0;
+		{
+			IntrusivePtr<const IntrusiveMock> ptr{{}, &counter};
+			QCOMPARE(ptr->getUsageCnt(), 1ull);
+		}
+		QCOMPARE(counter, 1);
+	}
+
+	void test_copy() {
+		int counter = 0;
+		{
+			IntrusivePtr<IntrusiveMock> ptr1{{}, &counter};
+			{
+				IntrusivePtr<IntrusiveMock> ptr2 = ptr1;
+				QCOMPARE(ptr1->getUsageCnt(), 2ull);
+				QVERIFY(ptr1 == ptr2);
+			}
+			QCOMPARE(ptr1->getUsageCnt(), 1ull);
+			QCOMPARE(counter, 0);
+		}
+		QCOMPARE(counter, 1);
+	}
+
+	void test_move() {
+		int counter = 0;
+		IntrusivePtr<IntrusiveMock> ptr1{{}, &counter};
+		IntrusivePtr<IntrusiveMock> ptr2 = std::move(ptr1);
+		QVERIFY(ptr1 == nullptr);
+		QCOMPARE(ptr2->getUsageCnt(), 1ull);
+		ptr1 = std::move(ptr2);
+		QCOMPARE(ptr1->getUsageCnt(), 1ull);
+		ptr1 = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_assign() {
+		int counter1 = 0;
+		int counter2 = 0;
+		IntrusivePtr<IntrusiveMock> ptr1{{}, &counter1};
+		IntrusivePtr<IntrusiveMock> ptr2{{}, &counter2};
+		ptr1 = ptr2;
+		QCOMPARE(counter1, 1);
+		QCOMPARE(ptr2->getUsageCnt(), 2ull);
+		ptr1 = ptr1;
+		QCOMPARE(ptr2->getUsageCnt(), 2ull);
+	}
+
+	void test_readopt() {
+		int counter = 0;
+		IntrusivePtr<IntrusiveMock> ptr1{{}, &counter};
+		IntrusiveMock* raw = ptr1.___getPtr();
+		{
+			IntrusivePtr<IntrusiveMock> ptr2 = raw->self();
+			QCOMPARE(ptr1->getUsageCnt(), 2ull);
+			QVERIFY(ptr1 == ptr2);
+			IntrusivePtr<const IntrusiveMock> ptr3 = static_cast<const IntrusiveMock*>(raw)->self();
+			QCOMPARE(ptr1->getUsageCnt(), 3ull);
+		}
+		ptr1 = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_copy_object() {
+		int counter = 0;
+		IntrusivePtr<IntrusiveMock> ptr1{{}, &counter};
+		IntrusivePtr<IntrusiveMock> ptr2{{}, *ptr1};
+		QCOMPARE(ptr1->getUsageCnt(), 1ull);
+		QCOMPARE(ptr2->getUsageCnt(), 1ull);
+		*ptr2 = *ptr1;
+		QCOMPARE(ptr2->getUsageCnt(), 1ull);
+	}
+
+	void test_derived() {
+		int counter = 0;
+		{
+			IntrusivePtr<IntrusiveMockDerived> derived{{}, &counter, 7};
+			IntrusivePtr<IntrusiveMock> base = derived;
+			QCOMPARE(derived->getUsageCnt(), 2ull);
+			IntrusivePtr<const IntrusiveMock> cbase = std::move(derived);
+			QVERIFY(derived == nullptr);
+			QCOMPARE(base->getUsageCnt(), 2ull);
+		}
+		QCOMPARE(counter, 1);
+	}
+
+	void test_aggregate() {
+		IntrusivePtr<IntrusivePos> pos{{}, 3, 4};
+		QCOMPARE(pos->x, 3);
+		QCOMPARE(pos->y, 4);
+		QCOMPARE(pos->getUsageCnt(), 1ull);
+		IntrusivePtr<const IntrusivePos> zero{InplaceConstructorTag{}};
+		QCOMPARE(zero->x, 0);
+	}
+
+	void test_as_1() {
+		int counter = 0;
+		IntrusivePtr<IntrusiveMock> base = IntrusivePtr<IntrusiveMockDerived>{{}, &counter, 7};
+		WeakPtr<IntrusiveMockDerived> derived = base.as<IntrusiveMockDerived>();
+		QCOMPARE(derived->value, 7);
+		QCOMPARE(base.asStatic<IntrusiveMockDerived>(), derived);
+	}
+
+	void test_as_2() {
+		int counter = 0;
+		IntrusivePtr<IntrusiveMock> base{{}, &counter};
+		QVERIFY(base.as<IntrusiveMockDerived>() == nullptr);
+		QVERIFY(base.asIntrusive<IntrusiveMockDerived>() == nullptr);
+		QCOMPARE(base->getUsageCnt(), 1ull);
+	}
+
+	void test_asIntrusive() {
+		int counter = 0;
+		IntrusivePtr<IntrusiveMock> base = IntrusivePtr<IntrusiveMockDerived>{{}, &counter, 7};
+		IntrusivePtr<IntrusiveMockDerived> derived1 = base.asIntrusive<IntrusiveMockDerived>();
+		IntrusivePtr<IntrusiveMockDerived> derived2 = base.asIntrusiveStatic<IntrusiveMockDerived>();
+		QCOMPARE(derived1->value, 7);
+		QVERIFY(derived1 == derived2);
+		QCOMPARE(base->getUsageCnt(), 3ull);
+		base = nullptr;
+		derived1 = nullptr;
+		derived2 = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_hash() {
+		int counter = 0;
+		IntrusivePtr<IntrusiveMock> ptr1{{}, &counter};
+		IntrusivePtr<IntrusiveMock> ptr2{{}, &counter};
+		std::unordered_set<IntrusivePtr<IntrusiveMock>> set{ptr1, ptr2, ptr1};
+		QCOMPARE(set.size(), 2u);
+	}
+
+	void test_threads() {
+		constexpr int THREAD_CNT = 8;
+		std::atomic<int> counter = 0;
+		{
+			IntrusivePtr<ConcurrentIntrusiveMock> ptr{{}, &counter};
+			std::vector<std::thread> threads;
+			for (int t = 0; t < THREAD_CNT; ++t) {
+				threads.emplace_back([ptr]() {
+					for (int i = 0; i < 20000; ++i) {
+						IntrusivePtr<ConcurrentIntrusiveMock> copy = ptr;
+						IntrusivePtr<ConcurrentIntrusiveMock> readopted{copy.___getPtr()};
+					}
+				});
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			QCOMPARE(ptr->getUsageCnt(), 1ull);
+		}
+		QCOMPARE(counter.load(), 1);
+	}
+
+};
+CAT_DECLARE_TEST(IntrusivePtrTest);
+
+
+
+#include "intrusivePtrTest.moc"
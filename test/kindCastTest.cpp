@@ -0,0 +1,151 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "catPointers.h"
+
+using namespace cat;
+
+namespace {
+
+/**
+ * Not polymorphic at all, so dynamic_cast<>() could not be used for a downcast:
+ *   Shape [0, 4]
+ *     Circle [1, 1]
+ *     Polygon [2, 4]
+ *       Triangle [3, 3]
+ *       Square [4, 4]
+ */
+struct Shape {
+	const Kind kind;
+	Kind getKind() const { return kind; }
+protected:
+	Shape(Kind kind): kind(kind) {}
+};
+CAT_KIND_RANGE(Shape, 0, 4)
+
+struct Circle: Shape {
+	Circle(): Shape(1) {}
+};
+CAT_KIND_RANGE(Circle, 1, 1)
+
+struct Polygon: Shape {
+protected:
+	using Shape::Shape;
+};
+CAT_KIND_RANGE(Polygon, 2, 4)
+
+struct Triangle: Polygon {
+	Triangle(): Polygon(3) {}
+};
+CAT_KIND_RANGE(Triangle, 3, 3)
+
+struct Square: Polygon {
+	Square(): Polygon(4) {}
+};
+CAT_KIND_RANGE(Square, 4, 4)
+
+/**
+ * Polymorphic, with a subclass that did not declare a range of its own.
+ */
+struct Animal {
+	const Kind kind;
+	Animal(Kind kind = 0): kind(kind) {}
+	virtual ~Animal() {}
+	Kind getKind() const { return kind; }
+};
+CAT_KIND_RANGE(Animal, 0, 1)
+
+struct Dog: Animal {
+	Dog(): Animal(1) {}
+};
+CAT_KIND_RANGE(Dog, 1, 1)
+
+struct Puppy: Dog {};
+
+}
+
+class KindCastTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	KindCastTest() {}
+	~KindCastTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_kindRange() {
+		QVERIFY(hasKindRange_v<Shape>);
+		QVERIFY(hasKindRange_v<const Square>);
+		QVERIFY(not hasKindRange_v<Puppy>); // not inherited.
+		QVERIFY(not hasKindRange_v<int>);
+		QCOMPARE(kindRange_v<Polygon>.first, 2u);
+		QCOMPARE(kindRange_v<Polygon>.last, 4u);
+		QVERIFY(kindRange_v<Polygon>.contains(2));
+		QVERIFY(kindRange_v<Polygon>.contains(4));
+		QVERIFY(not kindRange_v<Polygon>.contains(1));
+		QVERIFY(not kindRange_v<Polygon>.contains(5));
+	}
+
+	void test_kindCast() {
+		Triangle triangle;
+		Shape* shape = &triangle;
+		QCOMPARE(kindCast<Triangle>(shape), &triangle);
+		QCOMPARE(kindCast<Polygon>(shape), static_cast<Polygon*>(&triangle));
+		QCOMPARE(kindCast<Shape>(shape), shape);
+		QCOMPARE(kindCast<Square>(shape), nullptr);
+		QCOMPARE(kindCast<Circle>(shape), nullptr);
+		QCOMPARE(kindCast<Circle>(static_cast<Shape*>(nullptr)), nullptr);
+
+		const Shape* cShape = &triangle;
+		QCOMPARE(kindCast<const Triangle>(cShape), &triangle);
+	}
+
+	void test_kindCast_fallback() {
+		Puppy puppy;
+		Animal* animal = &puppy;
+		QCOMPARE(kindCast<Dog>(animal), static_cast<Dog*>(&puppy));
+		QCOMPARE(kindCast<Puppy>(animal), &puppy); // dynamic_cast<>()
+
+		Dog dog;
+		animal = &dog;
+		QCOMPARE(kindCast<Puppy>(animal), nullptr);
+	}
+
+	void test_weakPtr_as() {
+		Square square;
+		WeakPtr<Shape> shape{&square};
+		QCOMPARE(shape.as<Square>().___getPtr(), &square);
+		QCOMPARE(shape.as<Triangle>().___getPtr(), nullptr);
+	}
+
+	void test_owningPtr_as() {
+		OwningPtr<Animal> animal{new Dog()};
+		QCOMPARE(animal.as<Dog>().___getPtr(), static_cast<Dog*>(animal.___getPtr()));
+		OwningPtr<Dog> dog = animal.asOwning<Dog>();
+		QVERIFY(dog != nullptr);
+		QVERIFY(animal == nullptr);
+	}
+
+	void test_sharedPtr_as() {
+		SharedPtr<Animal> animal = SharedPtr<Dog>{{}};
+		QCOMPARE(animal.as<Dog>().___getPtr(), static_cast<Dog*>(animal.___getPtr()));
+		SharedPtr<Dog> dog = animal.asShared<Dog>();
+		QVERIFY(dog != nullptr);
+		QVERIFY(animal.asShared<Puppy>() == nullptr);
+
+		CompactSharedPtr<Animal> compact{{}, Kind(0)};
+		QVERIFY(compact.as<Dog>() == nullptr);
+		QVERIFY(compact.as<Animal>() != nullptr);
+	}
+
+};
+CAT_DECLARE_TEST(KindCastTest);
+
+
+
+#include "kindCastTest.moc"
@@ -0,0 +1,164 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_offsetPtr.h"
+
+#include <cstring>
+#include <memory>
+
+using namespace cat;
+
+namespace {
+
+struct Node {
+	int value = 0;
+	OffsetWeakPtr<Node> parent;
+	OffsetArray<OffsetOwningPtr<Node>> children;
+	OffsetOwningPtr<Node> next;
+};
+
+struct Holder {
+	OffsetWeakPtr<int> ptr;
+	int value = 0;
+};
+
+/**
+ * Writes a root with childCnt children, each of which has a chain of one node.
+ */
+RelocatableWriter writeTree(int childCnt) {
+	RelocatableWriter writer;
+	auto root = writer.create<Node>();
+	auto children = writer.createArray<OffsetOwningPtr<Node>>(childCnt);
+	writer.get(root)->value = -1;
+	writer.get(root)->children = {writer.get(children), size_t(childCnt)};
+	for (int i = 0; i < childCnt; ++i) {
+		auto child = writer.create<Node>();
+		auto grandChild = writer.create<Node>();
+		writer.get(child)->value = i;
+		writer.get(child)->parent = writer.get(root);
+		writer.get(child)->next.reset(writer.get(grandChild));
+		writer.get(grandChild)->value = 100 + i;
+		writer.get(grandChild)->parent = writer.get(child);
+		writer.get(children)[i].reset(writer.get(child));
+	}
+	return writer;
+}
+
+void verifyTree(const Node* root, int childCnt) {
+	QCOMPARE(root->value, -1);
+	QVERIFY(root->parent == nullptr);
+	QCOMPARE(root->children.size(), size_t(childCnt));
+	int i = 0;
+	for (const auto& child : root->children) {
+		QCOMPARE(child->value, i);
+		QCOMPARE(child->parent.___getPtr(), root);
+		QVERIFY(child->children.empty());
+		QCOMPARE(child->next->value, 100 + i);
+		QCOMPARE(child->next->parent.___getPtr(), child.___getPtr());
+		QVERIFY(child->next->next == nullptr);
+		++i;
+	}
+}
+
+}
+
+class OffsetPtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	OffsetPtrTest() {}
+	~OffsetPtrTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_offsetWeakPtr() {
+		int value = 7;
+		OffsetWeakPtr<int> ptr;
+		QVERIFY(ptr == nullptr);
+		QVERIFY(not ptr);
+		ptr = &value;
+		QVERIFY(ptr != nullptr);
+		QCOMPARE(ptr.___getPtr(), &value);
+		QCOMPARE(*ptr, 7);
+		QCOMPARE(ptr.getWeak().___getPtr(), &value);
+
+		OffsetWeakPtr<int> copy = ptr; // lives at another address
+		QCOMPARE(copy.___getPtr(), &value);
+		QVERIFY(copy == ptr);
+		copy = nullptr;
+		QVERIFY(copy == nullptr);
+		QVERIFY(copy != ptr);
+	}
+
+	void test_offsetOwningPtr_move() {
+		Node nodes[2];
+		nodes[0].next.reset(&nodes[1]);
+		QCOMPARE(nodes[0].next.___getPtr(), &nodes[1]);
+		OffsetOwningPtr<Node> moved = std::move(nodes[0].next);
+		QCOMPARE(moved.___getPtr(), &nodes[1]);
+		QVERIFY(nodes[0].next == nullptr);
+		nodes[1].next = std::move(moved);
+		QCOMPARE(nodes[1].next.___getPtr(), &nodes[1]);
+		QVERIFY(moved == nullptr);
+	}
+
+	void test_offsetArray() {
+		int values[3] = {1, 2, 3};
+		OffsetArray<int> array{values, 3};
+		QCOMPARE(array.size(), size_t(3));
+		QCOMPARE(array[2], 3);
+		int sum = 0;
+		for (int v : array) {
+			sum += v;
+		}
+		QCOMPARE(sum, 6);
+		OffsetArray<int> empty;
+		QVERIFY(empty.empty());
+		QCOMPARE(empty.begin(), empty.end());
+	}
+
+	void test_writer_tree() {
+		RelocatableWriter writer = writeTree(10);
+		verifyTree(relocatableRoot<Node>(writer.data()), 10);
+	}
+
+	void test_writer_relocate() {
+		RelocatableWriter writer = writeTree(50);
+		const std::vector<std::byte> buffer = writer.release();
+		QVERIFY(writer.size() == 0);
+
+		// as if written to a file and mapped back to another address:
+		std::unique_ptr<std::max_align_t[]> loaded{new std::max_align_t[buffer.size() / sizeof(std::max_align_t) + 1]};
+		std::memcpy(loaded.get(), buffer.data(), buffer.size());
+		verifyTree(relocatableRoot<Node>(static_cast<const void*>(loaded.get())), 50);
+
+		Node* root = relocatableRoot<Node>(static_cast<void*>(loaded.get()));
+		root->children[3]->value = 33;
+		QCOMPARE(root->children[3].getWeak()->value, 33);
+	}
+
+	void test_writer_alignment() {
+		RelocatableWriter writer;
+		auto c = writer.create<char>('a');
+		auto d = writer.create<double>(1.5);
+		auto h = writer.create<Holder>();
+		QCOMPARE(c.offset, size_t(0));
+		QCOMPARE(d.offset % alignof(double), size_t(0));
+		QCOMPARE(h.offset % alignof(Holder), size_t(0));
+		writer.get(h)->ptr = &writer.get(h)->value;
+		writer.get(h)->value = 5;
+		QCOMPARE(*writer.get(h)->ptr, 5);
+		QCOMPARE(*writer.get(d), 1.5);
+	}
+
+};
+CAT_DECLARE_TEST(OffsetPtrTest);
+
+
+
+#include "offsetPtrTest.moc"
@@ -5,6 +5,9 @@
 // add necessary includes here
 #include "cat_owningPtr.h"
 
+#include <memory_resource>
+#include <vector>
+
 using namespace cat;
 
 struct IGeometry {
@@ -32,6 +35,53 @@ struct Line: PointBase, IGeometry {
     {};
 };
 
+namespace {
+
+struct CountingResource: std::pmr::memory_resource {
+    int allocations = 0;
+    int deallocations = 0;
+    size_t bytesInUse = 0;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        bytesInUse += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        ++deallocations;
+        bytesInUse -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct ArenaNode {
+    int* dtorCnt;
+    std::vector<ArenaOwningPtr<ArenaNode>> children;
+
+    ArenaNode(int* dtorCnt) : dtorCnt(dtorCnt), children() {}
+    ~ArenaNode() { (*dtorCnt)++; }
+};
+
+struct SkippedArenaNode {
+    int* dtorCnt;
+    ArenaOwningPtr<SkippedArenaNode> left;
+    ArenaOwningPtr<SkippedArenaNode> right;
+
+    SkippedArenaNode(int* dtorCnt) : dtorCnt(dtorCnt), left(), right() {}
+    ~SkippedArenaNode() { (*dtorCnt)++; }
+};
+
+}
+
+template <>
+struct cat::SkipArenaDestruction<SkippedArenaNode>: std::true_type {};
+
 class OwningPtrTest : public QObject
 {
     Q_OBJECT
@@ -83,6 +133,23 @@ private slots:
         QCOMPARE(ptr2->id, ptr1Ptr->id);
     }
 
+    void test_assign_self() {
+        OwningPtr<int> ptr{{}, 7};
+        int* target = ptr.___getPtr();
+        OwningPtr<int>& alias = ptr;
+        ptr = std::move(alias);
+        QCOMPARE(ptr.___getPtr(), target);
+        QCOMPARE(*ptr, 7);
+    }
+
+    void test_release() {
+        OwningPtr<int> ptr{{}, 7};
+        int* target = ptr.release();
+        QCOMPARE(ptr.___getPtr(), nullptr);
+        QCOMPARE(*target, 7);
+        ptr.getDeleter()(target);
+    }
+
     void test_as_1() {
         OwningPtr<Point2> ptr{{}, -5, 5};
         auto base = ptr.as<PointBase>();
@@ -106,6 +173,115 @@ private slots:
         QVERIFY(not (bool)ptr);
     }
 
+    void test_sizeof() {
+        QCOMPARE(sizeof(OwningPtr<int>), sizeof(int*));
+    }
+
+    void test_pmr_ctor() {
+        CountingResource resource;
+        {
+            PmrOwningPtr<Point2> ptr{&resource, {}, -5, 5};
+            QCOMPARE(resource.allocations, 1);
+            QCOMPARE(ptr.getDeleter().resource(), &resource);
+            QCOMPARE(ptr->x, -5);
+            QCOMPARE(ptr->y, 5);
+        }
+        QCOMPARE(resource.deallocations, 1);
+        QCOMPARE(resource.bytesInUse, 0u);
+    }
+
+    void test_pmr_move() {
+        CountingResource resource;
+        PmrOwningPtr<Line> ptr1{&resource, {}, Point2{1, 2}, Point2{3, 4}};
+        PmrOwningPtr<IGeometry> ptr2;
+        ptr2 = std::move(ptr1);
+        QCOMPARE(ptr1.___getPtr(), nullptr);
+        QCOMPARE(ptr2.getDeleter().resource(), &resource);
+        ptr2 = nullptr;
+        QCOMPARE(resource.deallocations, 1);
+        QCOMPARE(resource.bytesInUse, 0u);
+    }
+
+    void test_pmr_asOwning() {
+        CountingResource resource;
+        PmrOwningPtr<IGeometry> ptr1{OwningPtr<Line, PmrDelete>{&resource, {}, Point2{1, 2}, Point2{3, 4}}};
+        PmrOwningPtr<Line> ptr2 = ptr1.asOwning<Line>();
+        QCOMPARE(ptr1.___getPtr(), nullptr);
+        QCOMPARE(ptr2->p2.x, 3);
+        ptr2 = nullptr;
+        QCOMPARE(resource.deallocations, 1);
+        QCOMPARE(resource.bytesInUse, 0u);
+    }
+
+    void test_pmr_rawPointer() {
+        // the default PmrDelete has no resource to give the memory back to:
+        static_assert(not std::is_constructible_v<PmrOwningPtr<Point2>, Point2*>);
+        static_assert(not std::is_convertible_v<Point2*, PmrOwningPtr<Point2>>);
+        static_assert(std::is_constructible_v<PmrOwningPtr<Point2>, Point2*, PmrDelete>);
+        static_assert(std::is_constructible_v<OwningPtr<Point2>, Point2*>);
+
+        CountingResource resource;
+        PmrOwningPtr<Point2> ptr1{&resource, {}, 1, 2};
+        PmrDelete deleter = ptr1.getDeleter();
+        PmrOwningPtr<Point2> ptr2{ptr1.release(), deleter}; // adopted together with its deleter.
+        QCOMPARE(ptr2->y, 2);
+        ptr2 = nullptr;
+        QCOMPARE(resource.bytesInUse, 0u);
+    }
+
+    void test_arena_ctor() {
+        CountingResource upstream;
+        {
+            std::pmr::monotonic_buffer_resource arena{4096, &upstream};
+            {
+                ArenaOwningPtr<Point2> ptr1{arena, {}, -5, 5};
+                ArenaOwningPtr<const Point2> ptr2{arena, {}, 3, 4};
+                QCOMPARE(sizeof(ptr1), sizeof(Point2*));
+                QCOMPARE(ptr1->x, -5);
+                QCOMPARE(ptr2->y, 4);
+            }
+            QCOMPARE(upstream.allocations, 1);
+            QCOMPARE(upstream.deallocations, 0);
+        }
+        QCOMPARE(upstream.deallocations, 1);
+        QCOMPARE(upstream.bytesInUse, 0u);
+    }
+
+    void test_arena_dtor() {
+        std::pmr::monotonic_buffer_resource arena;
+        int dtorCnt = 0;
+        {
+            ArenaOwningPtr<ArenaNode> root{arena, {}, &dtorCnt};
+            for (int i = 0; i < 10; ++i) {
+                root->children.emplace_back(arena, InplaceConstructorTag{}, &dtorCnt);
+            }
+        }
+        QCOMPARE(dtorCnt, 11);
+
+        ArenaOwningPtr<IGeometry> geometry{ArenaOwningPtr<Line>{arena, {}, Point2{1, 2}, Point2{3, 4}}};
+        auto line = geometry.asOwning<Line>();
+        QCOMPARE(line->p1.y, 2);
+    }
+
+    void test_arena_rawPointer() {
+        // ArenaDelete only destroys, a target allocated with new would leak:
+        static_assert(not std::is_constructible_v<ArenaOwningPtr<Point2>, Point2*>);
+        static_assert(not std::is_convertible_v<Point2*, ArenaOwningPtr<Point2>>);
+        static_assert(std::is_constructible_v<ArenaOwningPtr<Point2>, Point2*, ArenaDelete>);
+    }
+
+    void test_arena_skipDestruction() {
+        int dtorCnt = 0;
+        {
+            std::pmr::monotonic_buffer_resource arena;
+            ArenaOwningPtr<SkippedArenaNode> root{arena, {}, &dtorCnt};
+            root->left = ArenaOwningPtr<SkippedArenaNode>{arena, {}, &dtorCnt};
+            root->right = ArenaOwningPtr<SkippedArenaNode>{arena, {}, &dtorCnt};
+            root->left->left = ArenaOwningPtr<SkippedArenaNode>{arena, {}, &dtorCnt};
+        }
+        QCOMPARE(dtorCnt, 0);
+    }
+
 };
 CAT_DECLARE_TEST(OwningPtrTest);
 
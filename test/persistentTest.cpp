@@ -0,0 +1,225 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_persistent.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cat;
+
+namespace {
+
+/**
+ * Sends every key to the same few hashes, to force collision nodes.
+ */
+struct BadHash {
+	size_t operator()(int key) const noexcept { return size_t(key % 3); }
+};
+
+template <class T_, class Counting_>
+std::vector<T_> toVector(const PersistentVector<T_, Counting_>& v) {
+	std::vector<T_> result;
+	v.forEach([&](const T_& value) { result.push_back(value); });
+	return result;
+}
+
+template <class Map_>
+std::map<typename Map_::Key, typename Map_::Value> toMap(const Map_& m) {
+	std::map<typename Map_::Key, typename Map_::Value> result;
+	m.forEach([&](const auto& key, const auto& value) { result.emplace(key, value); });
+	return result;
+}
+
+}
+
+class PersistentTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	PersistentTest() {}
+	~PersistentTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_vector_pushBack() {
+		PersistentVector<int> v;
+		QVERIFY(v.empty());
+		for (int i = 0; i < 40000; ++i) { // 4 levels
+			v.pushBack(i);
+		}
+		QCOMPARE(v.size(), size_t(40000));
+		for (int i = 0; i < 40000; i += 7) {
+			QCOMPARE(v[size_t(i)], i);
+		}
+		QCOMPARE(v.back(), 39999);
+		const auto values = toVector(v);
+		QCOMPARE(values.size(), size_t(40000));
+		QCOMPARE(values[1234], 1234);
+	}
+
+	void test_vector_snapshots() {
+		PersistentVector<std::string> v;
+		for (int i = 0; i < 1000; ++i) {
+			v.pushBack(std::to_string(i));
+		}
+		const PersistentVector<std::string> snapshot = v;
+		v.set(500, "changed");
+		v.pushBack("new");
+		QCOMPARE(v[500], std::string("changed"));
+		QCOMPARE(snapshot[500], std::string("500"));
+		QCOMPARE(snapshot.size(), size_t(1000));
+		QCOMPARE(v.size(), size_t(1001));
+		QCOMPARE(&v[0], &snapshot[0]); // the untouched leaves are shared.
+		QVERIFY(&v[500] != &snapshot[500]);
+
+		const auto v2 = snapshot.withSet(0, "zero").withPushBack("x");
+		QCOMPARE(v2[0], std::string("zero"));
+		QCOMPARE(v2.back(), std::string("x"));
+		QCOMPARE(snapshot[0], std::string("0"));
+	}
+
+	void test_vector_transientInPlace() {
+		PersistentVector<int> v;
+		for (int i = 0; i < 100; ++i) {
+			v.pushBack(i);
+		}
+		const int* address = &v[50];
+		v.set(50, -1); // not shared, so no copy.
+		QCOMPARE(&v[50], address);
+		QCOMPARE(v[50], -1);
+	}
+
+	void test_vector_popBack() {
+		PersistentVector<int> v;
+		for (int i = 0; i < 2000; ++i) {
+			v.pushBack(i);
+		}
+		const auto snapshot = v;
+		for (int i = 1999; i >= 10; --i) {
+			QCOMPARE(v.back(), i);
+			v.popBack();
+		}
+		QCOMPARE(v.size(), size_t(10));
+		QCOMPARE(toVector(v), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+		v.pushBack(10);
+		QCOMPARE(v.back(), 10);
+		while (not v.empty()) {
+			v.popBack();
+		}
+		QCOMPARE(snapshot.size(), size_t(2000));
+		QCOMPARE(snapshot[1999], 1999);
+		QCOMPARE(snapshot.withPopBack().back(), 1998);
+	}
+
+	void test_map_basic() {
+		PersistentMap<std::string, int> m;
+		QVERIFY(m.find("a") == nullptr);
+		m.set("a", 1);
+		m.set("b", 2);
+		m.set("a", 3);
+		QCOMPARE(m.size(), size_t(2));
+		QCOMPARE(*m.find("a"), 3);
+		QCOMPARE(*m.find("b"), 2);
+		QVERIFY(not m.contains("c"));
+		QVERIFY(m.erase("a"));
+		QVERIFY(not m.erase("a"));
+		QCOMPARE(m.size(), size_t(1));
+		QVERIFY(m.erase("b"));
+		QVERIFY(m.empty());
+	}
+
+	void test_map_random() {
+		PersistentMap<int, int> m;
+		std::map<int, int> expected;
+		std::mt19937 random(7);
+		for (int i = 0; i < 20000; ++i) {
+			const int key = int(random() % 5000);
+			if (random() % 4 == 0) {
+				QCOMPARE(m.erase(key), expected.erase(key) != 0);
+			} else {
+				m.set(key, i);
+				expected[key] = i;
+			}
+		}
+		QCOMPARE(m.size(), expected.size());
+		QVERIFY(toMap(m) == expected);
+		for (int key = 0; key < 5000; ++key) {
+			const int* value = m.find(key);
+			auto it = expected.find(key);
+			QCOMPARE(value != nullptr, it != expected.end());
+			if (value != nullptr) {
+				QCOMPARE(*value, it->second);
+			}
+		}
+	}
+
+	void test_map_snapshots() {
+		PersistentMap<int, std::string> m;
+		for (int i = 0; i < 1000; ++i) {
+			m.set(i, std::to_string(i));
+		}
+		const auto snapshot = m;
+		m.set(5, "five");
+		m.erase(6);
+		m.set(1000, "new");
+		QCOMPARE(*snapshot.find(5), std::string("5"));
+		QVERIFY(snapshot.contains(6));
+		QVERIFY(not snapshot.contains(1000));
+		QCOMPARE(snapshot.size(), size_t(1000));
+		QCOMPARE(*m.find(5), std::string("five"));
+		QVERIFY(not m.contains(6));
+		QCOMPARE(m.find(7), snapshot.find(7)); // shared.
+
+		const auto m2 = snapshot.withSet(1, "one").withErase(2);
+		QCOMPARE(*m2.find(1), std::string("one"));
+		QVERIFY(not m2.contains(2));
+		QCOMPARE(*snapshot.find(1), std::string("1"));
+		QVERIFY(snapshot.contains(2));
+	}
+
+	void test_map_collisions() {
+		PersistentMap<int, int, BadHash> m;
+		for (int i = 0; i < 30; ++i) {
+			m.set(i, i * 10);
+		}
+		QCOMPARE(m.size(), size_t(30));
+		for (int i = 0; i < 30; ++i) {
+			QCOMPARE(*m.find(i), i * 10);
+		}
+		const auto snapshot = m;
+		for (int i = 0; i < 30; i += 2) {
+			QVERIFY(m.erase(i));
+		}
+		QCOMPARE(m.size(), size_t(15));
+		QVERIFY(not m.contains(4));
+		QCOMPARE(*m.find(5), 50);
+		QCOMPARE(*snapshot.find(4), 40);
+		for (int i = 1; i < 30; i += 2) {
+			QVERIFY(m.erase(i));
+		}
+		QVERIFY(m.empty());
+	}
+
+	void test_concurrentCounting() {
+		PersistentVector<int, AtomicCounting> v;
+		v.pushBack(1);
+		const auto snapshot = v;
+		v.set(0, 2);
+		QCOMPARE(snapshot[0], 1);
+		QCOMPARE(v[0], 2);
+	}
+
+};
+CAT_DECLARE_TEST(PersistentTest);
+
+
+
+#include "persistentTest.moc"
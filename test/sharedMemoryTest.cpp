@@ -0,0 +1,262 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_sharedMemory.h"
+#include "cat_offsetPtr.h"
+
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace cat;
+
+namespace {
+
+constexpr size_t VALUE_CNT = 10000;
+
+struct Dataset {
+	int values[VALUE_CNT];
+	OffsetWeakPtr<int> last;
+
+	Dataset(int start) {
+		for (size_t i = 0; i < VALUE_CNT; ++i) {
+			values[i] = start + int(i);
+		}
+		last = &values[VALUE_CNT - 1];
+	}
+};
+
+struct Position {
+	int x;
+	int y;
+};
+
+long long sum(const Dataset& dataset) {
+	long long sum = 0;
+	for (int value : dataset.values) {
+		sum += value;
+	}
+	return sum;
+}
+
+/**
+ * A unique segment name, that is unlinked before and after each test.
+ */
+struct SegmentName {
+	const std::string name = "/catPointersTest_" + std::to_string(::getpid());
+	SegmentName() { SharedMemorySegment::unlink(name.c_str()); }
+	~SegmentName() { SharedMemorySegment::unlink(name.c_str()); }
+	const char* c_str() const { return name.c_str(); }
+};
+
+/**
+ * Runs fn in a child process, returns true if it returned true.
+ */
+template <class Fn_>
+pid_t forkChild(Fn_&& fn) {
+	const pid_t pid = ::fork();
+	if (pid == 0) {
+		::_exit(fn() ? 0 : 1); // don't run the destructors of the parent's objects.
+	}
+	return pid;
+}
+
+bool waitForChild(pid_t pid) {
+	int status = 0;
+	return ::waitpid(pid, &status, 0) == pid and WIFEXITED(status) and WEXITSTATUS(status) == 0;
+}
+
+}
+
+class SharedMemoryTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	SharedMemoryTest() {}
+	~SharedMemoryTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_segment_allocate() {
+		const SegmentName name;
+		SharedMemorySegment segment = SharedMemorySegment::create(name.c_str(), 64 * 1024);
+		QVERIFY(segment.isMapped());
+		QCOMPARE(segment.usedBytes(), size_t(0));
+
+		void* a = segment.allocate(100);
+		void* b = segment.allocate(1000);
+		void* c = segment.allocate(100);
+		QVERIFY(segment.contains(a));
+		QCOMPARE(reinterpret_cast<std::uintptr_t>(b) % SharedMemorySegment::MAX_ALIGNMENT, std::uintptr_t(0));
+		QCOMPARE(segment.at(segment.offsetOf(b)), b);
+
+		segment.deallocate(b);
+		void* d = segment.allocate(500); // reuses b.
+		QCOMPARE(d, b);
+		segment.deallocate(a);
+		segment.deallocate(c);
+		segment.deallocate(d);
+		QCOMPARE(segment.usedBytes(), size_t(0));
+
+		bool threw = false;
+		try {
+			segment.allocate(1024 * 1024);
+		} catch (const std::bad_alloc&) {
+			threw = true;
+		}
+		QVERIFY(threw);
+	}
+
+	void test_segment_coalesce() {
+		const SegmentName name;
+		SharedMemorySegment segment = SharedMemorySegment::create(name.c_str(), 64 * 1024);
+		void* a = segment.allocate(1000);
+		void* b = segment.allocate(1000);
+		void* c = segment.allocate(1000);
+		void* guard = segment.allocate(100); // keeps a, b and c away from the never allocated space.
+
+		// merged with the next free block:
+		segment.deallocate(b);
+		segment.deallocate(a);
+		void* ab = segment.allocate(2000);
+		QCOMPARE(ab, a);
+		segment.deallocate(ab);
+
+		// merged with the free blocks on both sides:
+		segment.deallocate(c);
+		void* abc = segment.allocate(3000);
+		QCOMPARE(abc, a);
+		segment.deallocate(abc);
+
+		// merged with the previous free block, in any order:
+		void* x = segment.allocate(1000);
+		void* y = segment.allocate(1000);
+		QCOMPARE(x, a);
+		segment.deallocate(x);
+		segment.deallocate(y);
+		QCOMPARE(segment.allocate(2000), a);
+
+		// everything went back to the never allocated space:
+		segment.deallocate(a);
+		segment.deallocate(guard);
+		QCOMPARE(segment.usedBytes(), size_t(0));
+		void* all = segment.allocate(60 * 1024);
+		QCOMPARE(all, a);
+		segment.deallocate(all);
+	}
+
+	void test_segment_open() {
+		const SegmentName name;
+		SharedMemorySegment segment = SharedMemorySegment::create(name.c_str(), 64 * 1024);
+		int* value = static_cast<int*>(segment.allocate(sizeof(int)));
+		*value = 42;
+
+		SharedMemorySegment other = SharedMemorySegment::open(name.c_str());
+		QVERIFY(other.at(0) != segment.at(0)); // mapped a second time.
+		QCOMPARE(*static_cast<int*>(other.at(segment.offsetOf(value))), 42);
+
+		bool threw = false;
+		try {
+			SharedMemorySegment::create(name.c_str(), 64 * 1024);
+		} catch (const std::system_error&) {
+			threw = true;
+		}
+		QVERIFY(threw);
+	}
+
+	void test_processSharedPtr() {
+		const SegmentName name;
+		SharedMemorySegment segment = SharedMemorySegment::create(name.c_str(), 1024 * 1024);
+		{
+			ProcessSharedPtr<Dataset> ptr{segment, {}, 1};
+			QVERIFY(segment.contains(ptr.___getPtr()));
+			QCOMPARE(ptr.getUsageCnt(), size_t(1));
+			QCOMPARE(*ptr->last, int(VALUE_CNT));
+
+			ProcessSharedPtr<const Dataset> copy;
+			ProcessSharedPtr<Dataset> copy2 = ptr;
+			QCOMPARE(ptr.getUsageCnt(), size_t(2));
+			QVERIFY(copy2 == ptr);
+			ProcessSharedPtr<Dataset> moved = std::move(copy2);
+			QVERIFY(copy2 == nullptr);
+			QCOMPARE(ptr.getUsageCnt(), size_t(2));
+
+			auto handle = ptr.share();
+			QCOMPARE(ptr.getUsageCnt(), size_t(3));
+			ProcessSharedPtr<Dataset> adopted = ProcessSharedPtr<Dataset>::adopt(segment, handle);
+			QVERIFY(adopted == ptr);
+			QCOMPARE(ptr.getUsageCnt(), size_t(3));
+		}
+		QCOMPARE(segment.usedBytes(), size_t(0));
+	}
+
+	void test_processSharedPtr_aggregate() {
+		const SegmentName name;
+		SharedMemorySegment segment = SharedMemorySegment::create(name.c_str(), 64 * 1024);
+		{
+			ProcessSharedPtr<Position> ptr{segment, {}, 3, 4};
+			QCOMPARE(ptr->x, 3);
+			QCOMPARE(ptr->y, 4);
+		}
+		QCOMPARE(segment.usedBytes(), size_t(0));
+	}
+
+	void test_fork() {
+		const SegmentName name;
+		SharedMemorySegment segment = SharedMemorySegment::create(name.c_str(), 1024 * 1024);
+		ProcessSharedPtr<Dataset> ptr{segment, {}, 3};
+		const long long expected = sum(*ptr);
+
+		constexpr int CHILD_CNT = 4;
+		pid_t children[CHILD_CNT];
+		for (int i = 0; i < CHILD_CNT; ++i) {
+			const auto handle = ptr.share();
+			children[i] = forkChild([&]() {
+				// mapped again, so at another address than in the parent:
+				SharedMemorySegment childSegment = SharedMemorySegment::open(name.c_str());
+				ProcessSharedPtr<Dataset> childPtr = ProcessSharedPtr<Dataset>::adopt(childSegment, handle);
+				const bool ok = sum(*childPtr) == expected and *childPtr->last == 3 + int(VALUE_CNT) - 1;
+				ProcessSharedPtr<Dataset> copy = childPtr;
+				childPtr = nullptr;
+				copy = nullptr;
+				return ok;
+			});
+			QVERIFY(children[i] > 0);
+		}
+		for (int i = 0; i < CHILD_CNT; ++i) {
+			QVERIFY(waitForChild(children[i]));
+		}
+		QCOMPARE(ptr.getUsageCnt(), size_t(1));
+		ptr = nullptr;
+		QCOMPARE(segment.usedBytes(), size_t(0));
+	}
+
+	void test_fork_lastReleaseInChild() {
+		const SegmentName name;
+		SharedMemorySegment segment = SharedMemorySegment::create(name.c_str(), 1024 * 1024);
+		ProcessSharedPtr<Dataset> ptr{segment, {}, 0};
+		const auto handle = ptr.share();
+		ptr = nullptr;
+		QVERIFY(segment.usedBytes() != 0);
+
+		const pid_t child = forkChild([&]() {
+			SharedMemorySegment childSegment = SharedMemorySegment::open(name.c_str());
+			ProcessSharedPtr<Dataset>::adopt(childSegment, handle) = nullptr;
+			return childSegment.usedBytes() == 0;
+		});
+		QVERIFY(waitForChild(child));
+		QCOMPARE(segment.usedBytes(), size_t(0));
+	}
+
+};
+CAT_DECLARE_TEST(SharedMemoryTest);
+
+
+
+#include "sharedMemoryTest.moc"
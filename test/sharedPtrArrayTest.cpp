@@ -0,0 +1,245 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_sharedPtrArray.h"
+#include "cat_biasedCounting.h"
+
+#include <vector>
+
+using namespace cat;
+
+namespace {
+
+struct Counted {
+	static inline int destroyedCnt = 0;
+	int value;
+	Counted(int value): value(value) {}
+	~Counted() { destroyedCnt++; }
+};
+
+/**
+ * Counts every modification of a usage count, bulk or not.
+ */
+struct TracingBulkCounting: UnsyncedCounting {
+	static inline int modifications = 0;
+
+	static inline void increment(StorageT& cnt) noexcept {
+		modifications++;
+		UnsyncedCounting::increment(cnt);
+	}
+	static inline bool decrement(StorageT& cnt) noexcept {
+		modifications++;
+		return UnsyncedCounting::decrement(cnt);
+	}
+	static inline void add(StorageT& cnt, CntT n) noexcept {
+		modifications++;
+		UnsyncedCounting::add(cnt, n);
+	}
+	static inline bool subtract(StorageT& cnt, CntT n) noexcept {
+		modifications++;
+		return UnsyncedCounting::subtract(cnt, n);
+	}
+};
+
+/**
+ * No add() and subtract(), so the bulk operations fall back to single steps.
+ */
+struct SingleStepCounting {
+	using CntT = size_t;
+	using StorageT = CntT;
+	static constexpr bool HAS_WEAK_CNT = false;
+	static constexpr bool IS_THREAD_SAFE = false;
+
+	static inline CntT load(const StorageT& cnt) noexcept { return cnt; }
+	static inline void increment(StorageT& cnt) noexcept { cnt += 1; }
+	static inline bool decrement(StorageT& cnt) noexcept { return --cnt == 0; }
+	static inline bool incrementIfNotZero(StorageT& cnt) noexcept { return cnt != 0 and ++cnt; }
+};
+
+/**
+ * objectCnt objects, each referenced runLength times in a row.
+ */
+template <class Counting_>
+std::vector<SharedPtr<Counted, Counting_>> makeRuns(int objectCnt, int runLength) {
+	std::vector<SharedPtr<Counted, Counting_>> ptrs;
+	for (int i = 0; i < objectCnt; ++i) {
+		SharedPtr<Counted, Counting_> ptr{{}, i};
+		for (int j = 0; j < runLength; ++j) {
+			ptrs.push_back(ptr);
+		}
+	}
+	return ptrs;
+}
+
+}
+
+class SharedPtrArrayTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	SharedPtrArrayTest() {}
+	~SharedPtrArrayTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_hasBulkCounting() {
+		QVERIFY(_sharedPtr_internal::hasBulkCounting_v<UnsyncedCounting>);
+		QVERIFY(_sharedPtr_internal::hasBulkCounting_v<AtomicCounting>);
+		QVERIFY(_sharedPtr_internal::hasBulkCounting_v<ObservableCounting<AtomicCounting>>);
+		QVERIFY(not _sharedPtr_internal::hasBulkCounting_v<SingleStepCounting>);
+		QVERIFY(not _sharedPtr_internal::hasBulkCounting_v<BiasedCounting>);
+		QVERIFY(not _sharedPtr_internal::hasBulkCounting_v<ObservableCounting<SingleStepCounting>>);
+	}
+
+	void test_copyShared_mergesRuns() {
+		auto src = makeRuns<TracingBulkCounting>(10, 3);
+		std::vector<SharedPtr<Counted, TracingBulkCounting>> out(src.size(), nullptr);
+		TracingBulkCounting::modifications = 0;
+		copyShared(src.data(), src.size(), out.data());
+		QCOMPARE(TracingBulkCounting::modifications, 10);
+		for (size_t i = 0; i < src.size(); ++i) {
+			QVERIFY(out[i] == src[i]);
+			QCOMPARE(out[i]->value, int(i / 3));
+		}
+
+		Counted::destroyedCnt = 0;
+		src.clear();
+		QCOMPARE(Counted::destroyedCnt, 0);
+		TracingBulkCounting::modifications = 0;
+		releaseShared(out.data(), out.size());
+		QCOMPARE(TracingBulkCounting::modifications, 10);
+		QCOMPARE(Counted::destroyedCnt, 10);
+		for (const auto& ptr : out) {
+			QVERIFY(ptr == nullptr);
+		}
+	}
+
+	void test_bulk_mergesAdjacentOnly() {
+		SharedPtr<Counted, TracingBulkCounting> a{{}, 1};
+		SharedPtr<Counted, TracingBulkCounting> b{{}, 2};
+		std::vector<SharedPtr<Counted, TracingBulkCounting>> grouped{a, a, b};
+		std::vector<SharedPtr<Counted, TracingBulkCounting>> scattered{a, b, a};
+		std::vector<SharedPtr<Counted, TracingBulkCounting>> out(3, nullptr);
+
+		TracingBulkCounting::modifications = 0;
+		copyShared(grouped.data(), grouped.size(), out.data());
+		QCOMPARE(TracingBulkCounting::modifications, 2);
+		TracingBulkCounting::modifications = 0;
+		releaseShared(out.data(), out.size());
+		QCOMPARE(TracingBulkCounting::modifications, 2);
+
+		TracingBulkCounting::modifications = 0;
+		copyShared(scattered.data(), scattered.size(), out.data());
+		QCOMPARE(TracingBulkCounting::modifications, 3); // a is not merged across b.
+		TracingBulkCounting::modifications = 0;
+		releaseShared(out.data(), out.size());
+		QCOMPARE(TracingBulkCounting::modifications, 3);
+
+		// the counts are still right:
+		grouped.clear();
+		scattered.clear();
+		Counted::destroyedCnt = 0;
+		a = nullptr;
+		b = nullptr;
+		QCOMPARE(Counted::destroyedCnt, 2);
+	}
+
+	void test_releaseShared_nonConsecutive() {
+		SharedPtr<Counted> a{{}, 1};
+		SharedPtr<Counted> b{{}, 2};
+		std::vector<SharedPtr<Counted>> ptrs{a, b, nullptr, a, b, a};
+		a = nullptr;
+		Counted::destroyedCnt = 0;
+		releaseShared(ptrs.data(), 4);
+		QCOMPARE(Counted::destroyedCnt, 0); // ptrs[4] and ptrs[5] are still left.
+		QVERIFY(ptrs[3] == nullptr);
+		QVERIFY(ptrs[4] == b);
+		b = nullptr;
+		releaseShared(ptrs.data() + 4, 2);
+		QCOMPARE(Counted::destroyedCnt, 2);
+	}
+
+	void test_releaseShared_manyDisposals() {
+		auto ptrs = makeRuns<UnsyncedCounting>(1000, 1);
+		Counted::destroyedCnt = 0;
+		releaseShared(ptrs.data(), ptrs.size());
+		QCOMPARE(Counted::destroyedCnt, 1000);
+	}
+
+	void test_singleStepCounting() {
+		auto src = makeRuns<SingleStepCounting>(5, 4);
+		std::vector<SharedPtr<Counted, SingleStepCounting>> out(src.size(), nullptr);
+		copyShared(src.data(), src.size(), out.data());
+		Counted::destroyedCnt = 0;
+		releaseShared(src.data(), src.size());
+		QCOMPARE(Counted::destroyedCnt, 0);
+		releaseShared(out.data(), out.size());
+		QCOMPARE(Counted::destroyedCnt, 5);
+	}
+
+	void test_sharedPtrArray() {
+		Counted::destroyedCnt = 0;
+		{
+			SharedPtrArray<Counted, TracingBulkCounting> array;
+			auto src = makeRuns<TracingBulkCounting>(4, 2);
+			array.append(src.data(), src.size());
+			src.clear();
+			QCOMPARE(array.size(), size_t(8));
+			QCOMPARE(array[7]->value, 3);
+
+			TracingBulkCounting::modifications = 0;
+			SharedPtrArray<Counted, TracingBulkCounting> copy = array;
+			QCOMPARE(TracingBulkCounting::modifications, 4);
+			QVERIFY(copy[5] == array[5]);
+
+			array.resize(3);
+			QCOMPARE(array.size(), size_t(3));
+			QCOMPARE(Counted::destroyedCnt, 0);
+			copy.clear();
+			QVERIFY(copy.empty());
+			QCOMPARE(Counted::destroyedCnt, 2); // objects 2 and 3.
+
+			array.resize(5);
+			QVERIFY(array[4] == nullptr);
+			array.push_back(array[0]);
+			int sum = 0;
+			for (const auto& ptr : array) {
+				sum += ptr != nullptr ? ptr->value : 100;
+			}
+			QCOMPARE(sum, 0 + 0 + 1 + 100 + 100 + 0);
+
+			SharedPtrArray<Counted, TracingBulkCounting> moved = std::move(array);
+			QCOMPARE(moved.size(), size_t(6));
+			copy = moved;
+			moved = SharedPtrArray<Counted, TracingBulkCounting>();
+			QCOMPARE(Counted::destroyedCnt, 2);
+		}
+		QCOMPARE(Counted::destroyedCnt, 4);
+	}
+
+	void test_sharedPtrArray_concurrent() {
+		SharedPtrArray<Counted, AtomicCounting> array;
+		ConcurrentSharedPtr<Counted> ptr{{}, 7};
+		for (int i = 0; i < 100; ++i) {
+			array.push_back(ptr);
+		}
+		SharedPtrArray<Counted, AtomicCounting> copy = array;
+		Counted::destroyedCnt = 0;
+		ptr = nullptr;
+		array.clear();
+		QCOMPARE(Counted::destroyedCnt, 0);
+		copy.clear();
+		QCOMPARE(Counted::destroyedCnt, 1);
+	}
+
+};
+CAT_DECLARE_TEST(SharedPtrArrayTest);
+
+
+
+#include "sharedPtrArrayTest.moc"
@@ -5,6 +5,10 @@
 // add necessary includes here
 #include "cat_sharedPtr.h"
 
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
 using namespace cat;
 using namespace cat::_sharedPtr_internal;
 
@@ -33,6 +37,19 @@ struct DTorMockVirt: DTorMockVirtBase {
 	virtual ~DTorMockVirt() { (*cntr)++; }
 };
 
+struct IsolatedMock {
+	int value;
+};
+CAT_ISOLATED_USAGE_CNT(IsolatedMock)
+
+struct alignas(128) OverAlignedMock {
+	int value;
+};
+
+bool isAligned(const void* ptr, size_t alignment) {
+	return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
 
 class SharedPtrRefCntSeparate_Test : public QObject
 {
@@ -47,20 +64,22 @@ private slots:
 	void cleanupTestCase() {}
 
 	void test_ctor() {
-		SharedPtrRefCntSeparate_<int> obj{7};
+		int val = 5;
+		SharedPtrRefCntSeparate_<int> obj{7, &val};
         QCOMPARE(obj.getUsageCnt(), 7ull);
+		QCOMPARE(obj.get(), &val);
 	}
 
 	void test_incUsageCnt() {
-		SharedPtrRefCntSeparate_<int> obj{7};
+		SharedPtrRefCntSeparate_<int> obj{7, nullptr};
 		obj.incUsageCnt();
         QCOMPARE(obj.getUsageCnt(), 8ull);
 	}
 
 	void test_decUsageCnt_1() {
 		int* val = new int(5);
-		SharedPtrRefCntSeparate_<int> obj{7};
-		obj.decUsageCnt(val);
+		SharedPtrRefCntSeparate_<int> obj{7, val};
+		obj.decUsageCnt();
         QCOMPARE(obj.getUsageCnt(), 6ull);
 		delete val;
 	}
@@ -68,27 +87,32 @@ private slots:
 	void test_decUsageCnt_2() {
 		int counter = 0;
 		DTorMock* mock = new DTorMock(&counter);
-		SharedPtrRefCntSeparate_<DTorMock>* obj = new SharedPtrRefCntSeparate_<DTorMock>{1};
-		obj->decUsageCnt(mock);
+		SharedPtrRefCntSeparate_<DTorMock>* obj = new SharedPtrRefCntSeparate_<DTorMock>{1, mock};
+		obj->decUsageCnt();
 		QCOMPARE(counter, 1);
 	}
 
 	void test_dispose_1() {
 		int counter = 0;
 		DTorMock* mock = new DTorMock(&counter);
-		SharedPtrRefCntSeparate_<DTorMock>* obj = new SharedPtrRefCntSeparate_<DTorMock>{7};
-		obj->dispose(mock);
+		SharedPtrRefCntSeparate_<DTorMock>* obj = new SharedPtrRefCntSeparate_<DTorMock>{7, mock};
+		obj->dispose();
 		QCOMPARE(counter, 1);
 	}
 
 	void test_dispose_2() {
 		int counter = 0;
 		DTorMock* mock = new DTorMock(&counter);
-		SharedPtrRefCnt_* obj = new SharedPtrRefCntSeparate_<DTorMock>{7};
-		obj->dispose(mock);
+		SharedPtrRefCnt_* obj = new SharedPtrRefCntSeparate_<DTorMock>{7, mock};
+		obj->dispose();
 		QCOMPARE(counter, 1);
 	}
 
+	void test_not_polymorphic() {
+		QVERIFY(not std::is_polymorphic_v<SharedPtrRefCntSeparate_<DTorMockVirt>>);
+		QCOMPARE(sizeof(SharedPtrRefCntSeparate_<int>), sizeof(size_t) + 2 * sizeof(void*));
+	}
+
 };
 CAT_DECLARE_TEST(SharedPtrRefCntSeparate_Test);
 
@@ -120,36 +144,62 @@ private slots:
 
 	void test_decUsageCnt_1() {
 		SharedPtrRefCntInplace_<int> obj{8, 0};
-		obj.decUsageCnt(nullptr);
+		obj.decUsageCnt();
         QCOMPARE(obj.getUsageCnt(), 7ull);
 	}
 
 	void test_decUsageCnt_2() {
 		int counter = 0;
 		SharedPtrRefCntInplace_<DTorMock>* obj = new SharedPtrRefCntInplace_<DTorMock>{1, &counter};
-		obj->decUsageCnt(nullptr);
+		obj->decUsageCnt();
 		QCOMPARE(counter, 1);
 	}
 
 	void test_dispose_1() {
 		int counter = 0;
 		SharedPtrRefCntInplace_<DTorMock>* obj = new SharedPtrRefCntInplace_<DTorMock>{8, &counter};
-		obj->dispose(nullptr);
+		obj->dispose();
 		QCOMPARE(counter, 1);
 	}
 
    void test_dispose_2() {
 	   int counter = 0;
 	   SharedPtrRefCnt_* obj = new SharedPtrRefCntInplace_<DTorMock>{8, &counter};
-	   obj->dispose(nullptr);
+	   obj->dispose();
 	   QCOMPARE(counter, 1);
    }
 
+   void test_not_polymorphic() {
+	   QVERIFY(not std::is_polymorphic_v<SharedPtrRefCntInplace_<DTorMockVirt>>);
+	   QCOMPARE(sizeof(SharedPtrRefCntInplace_<void*>), sizeof(size_t) + 2 * sizeof(void*));
+   }
+
    void test_get() {
 	   SharedPtrRefCntInplace_<int>* obj = new SharedPtrRefCntInplace_<int>{8};
 	   QCOMPARE(obj->get(), &obj->data);
    }
 
+	void test_isolated_layout() {
+		using RefCnt = SharedPtrRefCntInplace_<IsolatedMock>;
+		QVERIFY(isolateUsageCnt_v<IsolatedMock>);
+		QVERIFY(not isolateUsageCnt_v<int>);
+		QCOMPARE(alignof(RefCnt), CACHE_LINE_SIZE);
+		QCOMPARE(sizeof(RefCnt), 2 * CACHE_LINE_SIZE);
+		RefCnt* obj = new RefCnt{1, 7};
+		QVERIFY(isAligned(obj, CACHE_LINE_SIZE));
+		QCOMPARE(reinterpret_cast<char*>(obj->get()) - reinterpret_cast<char*>(obj), std::ptrdiff_t(CACHE_LINE_SIZE));
+		QCOMPARE(obj->data.value, 7);
+		obj->decUsageCnt();
+	}
+
+	void test_over_aligned_layout() {
+		using RefCnt = SharedPtrRefCntInplace_<OverAlignedMock>;
+		QCOMPARE(alignof(RefCnt), 128ul);
+		RefCnt* obj = new RefCnt{1, 7};
+		QVERIFY(isAligned(obj->get(), 128));
+		obj->decUsageCnt();
+	}
+
 };
 CAT_DECLARE_TEST(SharedPtrRefCntInplace_Test);
 
@@ -299,11 +349,54 @@ private slots:
 CAT_DECLARE_TEST(SharedPtrData_Test);
 
 
+namespace {
+
+struct CountingResource: std::pmr::memory_resource {
+	int allocations = 0;
+	int deallocations = 0;
+	size_t bytesInUse = 0;
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		++allocations;
+		bytesInUse += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+		++deallocations;
+		bytesInUse -= bytes;
+		std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+};
+
+}
+
 struct PointBase { virtual ~PointBase() {} };
 struct Point: PointBase { int x, y;  Point(int x, int y) : x(x), y(y) {}; };
 
 struct LineBase { virtual ~LineBase() {} };
 
+/**
+ * UnsyncedCounting, that counts how often a usage count was modified.
+ */
+struct TracingCounting: UnsyncedCounting {
+	static inline int modifications = 0;
+
+	static inline void increment(StorageT& cnt) noexcept {
+		modifications++;
+		UnsyncedCounting::increment(cnt);
+	}
+	static inline bool decrement(StorageT& cnt) noexcept {
+		modifications++;
+		return UnsyncedCounting::decrement(cnt);
+	}
+};
+
 class SharedPtrTest : public QObject
 {
 	Q_OBJECT
@@ -337,6 +430,15 @@ private slots:
 		QCOMPARE(*shrPtr, 77);
 	}
 
+	void test_ctor_5() {
+		int counter = 0;
+		{
+			SharedPtr<const DTorMock> shrPtr{{}, &counter};
+			QCOMPARE(shrPtr->cntr, &counter);
+		}
+		QCOMPARE(counter, 1);
+	}
+
 	void test_as_1() {
 		SharedPtr<Point> shrPtr({}, 3, 5);
 		auto base = shrPtr.as<PointBase>();
@@ -383,11 +485,217 @@ private slots:
 		QCOMPARE(counter, 1);
 	}
 
+	void test_asShared_rvalue_1() {
+		SharedPtr<Point, TracingCounting> shrPtr({}, 3, 5);
+		Point* ptr = shrPtr.___getPtr();
+		TracingCounting::modifications = 0;
+		auto base = std::move(shrPtr).asShared<PointBase>();
+		QCOMPARE(TracingCounting::modifications, 0);
+		QCOMPARE(base.___getPtr(), static_cast<PointBase*>(ptr));
+		QVERIFY(shrPtr == nullptr);
+	}
+
+	void test_asShared_rvalue_2() {
+		SharedPtr<Point, TracingCounting> shrPtr({}, 3, 5);
+		TracingCounting::modifications = 0;
+		auto base = std::move(shrPtr).asShared<LineBase>();
+		QCOMPARE(TracingCounting::modifications, 0);
+		QVERIFY(base == nullptr);
+		QVERIFY(shrPtr != nullptr); // unchanged, because the cast failed.
+	}
+
+	void test_asSharedStatic_rvalue() {
+		int counter = 0;
+		SharedPtr<DTorMockVirtBase> shrPtr = SharedPtr<DTorMockVirt>{{}, &counter};
+		auto derived = std::move(shrPtr).asSharedStatic<DTorMockVirt>();
+		QVERIFY(shrPtr == nullptr);
+		QCOMPARE(derived->cntr, &counter);
+		derived = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_converting_move() {
+		int counter = 0;
+		SharedPtr<DTorMockVirt, TracingCounting> shrPtr{{}, &counter};
+		TracingCounting::modifications = 0;
+		SharedPtr<DTorMockVirtBase, TracingCounting> basePtr{std::move(shrPtr)};
+		QCOMPARE(TracingCounting::modifications, 0);
+		QVERIFY(shrPtr == nullptr);
+
+		SharedPtr<DTorMockVirt, TracingCounting> shrPtr2{{}, &counter};
+		TracingCounting::modifications = 0;
+		basePtr = std::move(shrPtr2);
+		QCOMPARE(TracingCounting::modifications, 1); // only releasing the old target.
+		QCOMPARE(counter, 1);
+		QVERIFY(shrPtr2 == nullptr);
+		basePtr = nullptr;
+		QCOMPARE(counter, 2);
+	}
+
+	void test_converting_copy_assignment() {
+		int counter = 0;
+		SharedPtr<DTorMockVirt, TracingCounting> shrPtr{{}, &counter};
+		SharedPtr<DTorMockVirtBase, TracingCounting> basePtr{nullptr};
+		basePtr = shrPtr;
+		QCOMPARE(basePtr.___getPtr(), static_cast<DTorMockVirtBase*>(shrPtr.___getPtr()));
+		TracingCounting::modifications = 0;
+		basePtr = shrPtr; // the same control block.
+		QCOMPARE(TracingCounting::modifications, 0);
+		shrPtr = nullptr;
+		QCOMPARE(counter, 0);
+		basePtr = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_isolated() {
+		SharedPtr<IsolatedMock> shrPtr{{}, 7};
+		QVERIFY(isAligned(shrPtr.___getPtr(), CACHE_LINE_SIZE));
+		QCOMPARE(shrPtr->value, 7);
+
+		std::pmr::unsynchronized_pool_resource resource;
+		SharedPtr<IsolatedMock> pmrPtr{&resource, {}, 8};
+		QVERIFY(isAligned(pmrPtr.___getPtr(), CACHE_LINE_SIZE));
+		QCOMPARE(pmrPtr->value, 8);
+	}
+
+	void test_over_aligned() {
+		SharedPtr<OverAlignedMock> shrPtr{{}, 7};
+		QVERIFY(isAligned(shrPtr.___getPtr(), 128));
+		QCOMPARE(shrPtr->value, 7);
+
+		std::pmr::unsynchronized_pool_resource resource;
+		SharedPtr<OverAlignedMock> pmrPtr{&resource, {}, 8};
+		QVERIFY(isAligned(pmrPtr.___getPtr(), 128));
+
+		CompactSharedPtr<OverAlignedMock> compact{{}, 9};
+		QVERIFY(isAligned(compact.___getPtr(), 128));
+		QCOMPARE(compact->value, 9);
+	}
+
 	void test_operator_bool() {
 		SharedPtr<int> shrPtr{nullptr};
 		QVERIFY(not (bool)shrPtr);
 	}
 
+	void test_pmr_ctor_1() {
+		CountingResource resource;
+		{
+			SharedPtr<Point> shrPtr{&resource, {}, 3, 5};
+			SharedPtr<Point> shrPtr2 = shrPtr;
+			QCOMPARE(resource.allocations, 1);
+			QCOMPARE(shrPtr->x, 3);
+			QCOMPARE(shrPtr->y, 5);
+		}
+		QCOMPARE(resource.deallocations, 1);
+		QCOMPARE(resource.bytesInUse, 0u);
+	}
+
+	void test_pmr_ctor_2() {
+		int counter = 0;
+		std::pmr::unsynchronized_pool_resource resource;
+		SharedPtr<DTorMockVirt> shrPtr{&resource, {}, &counter};
+		auto basePtr = shrPtr.asShared<DTorMockVirtBase>();
+		shrPtr = nullptr;
+		QCOMPARE(counter, 0);
+		basePtr = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_owning_ctor_1() {
+		int counter = 0;
+		{
+			OwningPtr<DTorMock> owning{{}, &counter};
+			DTorMock* target = owning.___getPtr();
+			SharedPtr<DTorMock> shrPtr = std::move(owning);
+			QCOMPARE(owning, nullptr);
+			QCOMPARE(shrPtr.___getPtr(), target);
+			SharedPtr<DTorMock> shrPtr2 = shrPtr;
+			shrPtr = nullptr;
+			QCOMPARE(counter, 0);
+		}
+		QCOMPARE(counter, 1);
+	}
+
+	void test_owning_ctor_2() {
+		int counter = 0;
+		{
+			SharedPtr<DTorMockVirtBase> shrPtr = OwningPtr<DTorMockVirt>{{}, &counter};
+			QVERIFY(shrPtr.as<DTorMockVirt>() != nullptr);
+		}
+		QCOMPARE(counter, 1);
+
+		SharedPtr<int> null = OwningPtr<int>{};
+		QCOMPARE(null, nullptr);
+	}
+
+	void test_owning_ctor_pmr() {
+		CountingResource resource;
+		{
+			PmrOwningPtr<Point> owning{&resource, {}, 3, 5};
+			SharedPtr<PointBase> shrPtr = std::move(owning);
+			QCOMPARE(resource.allocations, 1); // the control block comes from the global heap.
+			QCOMPARE(shrPtr.asStatic<Point>()->y, 5);
+		}
+		QCOMPARE(resource.deallocations, 1);
+		QCOMPARE(resource.bytesInUse, 0u);
+	}
+
+	void test_promotable_1() {
+		int counter = 0;
+		{
+			PromotableOwningPtr<DTorMock> owning{{}, &counter};
+			DTorMock* target = owning.___getPtr();
+			SharedPtr<DTorMock> shrPtr = std::move(owning);
+			QCOMPARE(shrPtr.___getPtr(), target);
+			SharedPtr<DTorMock> shrPtr2 = shrPtr;
+			QCOMPARE(counter, 0);
+		}
+		QCOMPARE(counter, 1);
+
+		{
+			PromotableOwningPtr<DTorMock> owning{{}, &counter};
+			QCOMPARE(owning->cntr, &counter);
+		}
+		QCOMPARE(counter, 2);
+	}
+
+	void test_promotable_2() {
+		int counter = 0;
+		{
+			OwningPtr<DTorMockVirtBase, PromotableDelete<>> owning = PromotableOwningPtr<DTorMockVirt>{{}, &counter};
+			SharedPtr<DTorMockVirtBase> shrPtr = std::move(owning);
+			QVERIFY(shrPtr.as<DTorMockVirt>() != nullptr);
+		}
+		QCOMPARE(counter, 1);
+	}
+
+	void test_promotable_3() {
+		int counter = 0;
+		PromotableOwningPtr<DTorMock, ObservableCounting<>> owning{{}, &counter};
+		ObservableSharedPtr<DTorMock> shrPtr = std::move(owning);
+		ObserverPtr<DTorMock> observer{shrPtr};
+		QVERIFY(observer.lock() != nullptr);
+		shrPtr = nullptr;
+		QCOMPARE(counter, 1);
+		QCOMPARE(observer.lock(), nullptr);
+	}
+
+	void test_promotable_raw() {
+		// a raw pointer has no control block to promote into:
+		static_assert(not std::is_constructible_v<PromotableOwningPtr<int>, int*>);
+		static_assert(not std::is_convertible_v<int*, PromotableOwningPtr<int>>);
+		static_assert(std::is_constructible_v<OwningPtr<int>, int*>);
+
+		PromotableOwningPtr<int> owning = nullptr;
+		QCOMPARE(owning, nullptr);
+		SharedPtr<int> shrPtr = std::move(owning);
+		QCOMPARE(shrPtr, nullptr);
+
+		owning = PromotableOwningPtr<int>{{}, 5};
+		owning = nullptr;
+		QCOMPARE(owning, nullptr);
+	}
+
 	void test_case1() {
 		SharedPtr<Point> p({}, 7, -7);
 	}
@@ -396,6 +704,352 @@ private slots:
 CAT_DECLARE_TEST(SharedPtrTest);
 
 
+class CompactSharedPtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	CompactSharedPtrTest() {}
+	~CompactSharedPtrTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_sizeof() {
+		QCOMPARE(sizeof(CompactSharedPtr<Point>), sizeof(Point*));
+		QCOMPARE(sizeof(CompactSharedPtr<Point, AtomicCounting>), sizeof(Point*));
+	}
+
+	void test_ctor_1() {
+		CompactSharedPtr<int> shrPtr{nullptr};
+		QCOMPARE(shrPtr, nullptr);
+		QCOMPARE(shrPtr.___getPtr(), nullptr);
+	}
+
+	void test_ctor_2() {
+		CompactSharedPtr<int> shrPtr{{}, 77};
+		QVERIFY(shrPtr != nullptr);
+		QCOMPARE(*shrPtr, 77);
+	}
+
+	void test_ctor_3() {
+		int counter = 0;
+		CompactSharedPtr<DTorMock> shrPtr1{{}, &counter};
+		{
+			CompactSharedPtr<DTorMock> shrPtr2{shrPtr1};
+			CompactSharedPtr<const DTorMock> shrPtr3{shrPtr2};
+			QCOMPARE(shrPtr2, shrPtr1);
+			QCOMPARE(shrPtr3.___getPtr(), shrPtr1.___getPtr());
+		}
+		QCOMPARE(counter, 0);
+		shrPtr1 = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_ctor_4() {
+		int counter = 0;
+		CompactSharedPtr<DTorMock> shrPtr1{{}, &counter};
+		CompactSharedPtr<DTorMock> shrPtr2{std::move(shrPtr1)};
+		QCOMPARE(shrPtr1, nullptr);
+		shrPtr2 = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_toSharedPtr() {
+		int counter = 0;
+		CompactSharedPtr<DTorMockVirt> compact{{}, &counter};
+		SharedPtr<DTorMockVirt> shrPtr = compact;
+		SharedPtr<DTorMockVirtBase> basePtr = compact;
+		QCOMPARE(shrPtr.___getPtr(), compact.___getPtr());
+		QCOMPARE(basePtr.___getPtr(), static_cast<DTorMockVirtBase*>(compact.___getPtr()));
+		compact = nullptr;
+		shrPtr = nullptr;
+		QCOMPARE(counter, 0);
+		basePtr = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_asShared_1() {
+		CompactSharedPtr<Point> shrPtr({}, 3, 5);
+		auto base = shrPtr.asShared<PointBase>();
+		QCOMPARE(base.___getPtr(), static_cast<PointBase*>(shrPtr.___getPtr()));
+	}
+
+	void test_asShared_2() {
+		CompactSharedPtr<Point> shrPtr({}, 3, 5);
+		auto base = shrPtr.asShared<LineBase>();
+		QCOMPARE(base.___getPtr(), nullptr);
+	}
+
+	void test_asShared_3() {
+		CompactSharedPtr<Point> shrPtr{nullptr};
+		auto base = shrPtr.asSharedStatic<PointBase>();
+		QCOMPARE(base, nullptr);
+	}
+
+	void test_asShared_rvalue() {
+		CompactSharedPtr<Point, TracingCounting> shrPtr({}, 3, 5);
+		Point* ptr = shrPtr.___getPtr();
+		TracingCounting::modifications = 0;
+		auto base = std::move(shrPtr).asShared<PointBase>();
+		QCOMPARE(TracingCounting::modifications, 0);
+		QCOMPARE(base.___getPtr(), static_cast<PointBase*>(ptr));
+		QVERIFY(shrPtr == nullptr);
+
+		CompactSharedPtr<Point, TracingCounting> shrPtr2({}, 3, 5);
+		auto line = std::move(shrPtr2).asShared<LineBase>();
+		QVERIFY(line == nullptr);
+		QVERIFY(shrPtr2 != nullptr);
+		auto base2 = std::move(shrPtr2).asSharedStatic<PointBase>();
+		QCOMPARE(TracingCounting::modifications, 0);
+		QVERIFY(shrPtr2 == nullptr);
+	}
+
+	void test_conversion_rvalue() {
+		int counter = 0;
+		CompactSharedPtr<DTorMockVirt, TracingCounting> compact{{}, &counter};
+		TracingCounting::modifications = 0;
+		SharedPtr<DTorMockVirtBase, TracingCounting> basePtr = std::move(compact);
+		QCOMPARE(TracingCounting::modifications, 0);
+		QVERIFY(compact == nullptr);
+		basePtr = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+};
+CAT_DECLARE_TEST(CompactSharedPtrTest);
+
+
+class ConcurrentSharedPtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	ConcurrentSharedPtrTest() {}
+	~ConcurrentSharedPtrTest() {}
+
+	static constexpr int THREAD_CNT = 8;
+	static constexpr int ITERATIONS = 20000;
+
+	template <class Fn>
+	static void runOnThreads(Fn fn) {
+		std::vector<std::thread> threads;
+		for (int i = 0; i < THREAD_CNT; ++i) {
+			threads.emplace_back(fn);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_refCnt_incUsageCnt() {
+		SharedPtrRefCntInplace_<int, AtomicCounting> obj{1, 0};
+		runOnThreads([&]() {
+			for (int i = 0; i < ITERATIONS; ++i) {
+				obj.incUsageCnt();
+			}
+		});
+		QCOMPARE(obj.getUsageCnt(), 1ull + THREAD_CNT * ITERATIONS);
+	}
+
+	void test_copy_and_destroy() {
+		int counter = 0;
+		ConcurrentSharedPtr<DTorMock> shrPtr{{}, &counter};
+		runOnThreads([&]() {
+			for (int i = 0; i < ITERATIONS; ++i) {
+				ConcurrentSharedPtr<DTorMock> copy1{shrPtr};
+				ConcurrentSharedPtr<DTorMock> copy2 = copy1;
+				copy1 = nullptr;
+			}
+		});
+		QCOMPARE(counter, 0);
+		shrPtr = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_last_release_on_other_thread() {
+		int counter = 0;
+		for (int i = 0; i < 100; ++i) {
+			std::vector<ConcurrentSharedPtr<DTorMockVirt>> copies;
+			{
+				ConcurrentSharedPtr<DTorMockVirt> shrPtr{{}, &counter};
+				for (int j = 0; j < THREAD_CNT; ++j) {
+					copies.push_back(shrPtr);
+				}
+			}
+			std::vector<std::thread> threads;
+			for (auto& copy : copies) {
+				threads.emplace_back([ptr = std::move(copy)]() mutable {
+					auto base = ptr.asShared<DTorMockVirtBase>();
+					ptr = nullptr;
+				});
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+		}
+		QCOMPARE(counter, 100);
+	}
+
+};
+CAT_DECLARE_TEST(ConcurrentSharedPtrTest);
+
+
+class ObserverPtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	ObserverPtrTest() {}
+	~ObserverPtrTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_sizeof() {
+		QCOMPARE(sizeof(SharedPtrRefCntInplace_<size_t>), 2 * sizeof(size_t) + sizeof(void*));
+		QCOMPARE(sizeof(SharedPtrRefCntInplace_<size_t, ObservableCounting<>>), 3 * sizeof(size_t) + sizeof(void*));
+		QCOMPARE(sizeof(ObservableSharedPtr<int>), sizeof(SharedPtr<int>));
+	}
+
+	void test_ctor_1() {
+		ObserverPtr<int> observer{nullptr};
+		QVERIFY(observer == nullptr);
+		QVERIFY(observer.expired());
+		QVERIFY(observer.lock() == nullptr);
+	}
+
+	void test_ctor_2() {
+		ObservableSharedPtr<int> shrPtr{{}, 5};
+		ObserverPtr<int> observer{shrPtr};
+		ObserverPtr<const int> observer2{observer};
+		QVERIFY(observer != nullptr);
+		QVERIFY(not observer.expired());
+		QCOMPARE(observer.___getPtr(), shrPtr.___getPtr());
+		QCOMPARE(observer2.___getPtr(), shrPtr.___getPtr());
+	}
+
+	void test_lock() {
+		int counter = 0;
+		ObservableSharedPtr<DTorMock> shrPtr{{}, &counter};
+		ObserverPtr<DTorMock> observer{shrPtr};
+		ObservableSharedPtr<DTorMock> locked = observer.lock();
+		QVERIFY(locked == shrPtr);
+		QCOMPARE(locked->cntr, &counter);
+		shrPtr = nullptr;
+		QCOMPARE(counter, 0);
+		QVERIFY(not observer.expired());
+		locked = nullptr;
+		QCOMPARE(counter, 1);
+	}
+
+	void test_weakCnt() {
+		auto* refCnt = new SharedPtrRefCntInplace_<int, ObservableCounting<>>(1, 5);
+		QCOMPARE(refCnt->getWeakCnt(), 1ull);
+		refCnt->incWeakCnt();
+		QCOMPARE(refCnt->getWeakCnt(), 2ull);
+		refCnt->decUsageCnt();
+		QCOMPARE(refCnt->getUsageCnt(), 0ull);
+		QCOMPARE(refCnt->getWeakCnt(), 1ull);
+		QVERIFY(not refCnt->tryIncUsageCnt());
+		refCnt->decWeakCnt();
+	}
+
+	void test_expired() {
+		int counter = 0;
+		ObserverPtr<DTorMock> observer{nullptr};
+		{
+			ObservableSharedPtr<DTorMock> shrPtr{{}, &counter};
+			observer = shrPtr;
+		}
+		// the payload is destroyed, but the control block is still alive:
+		QCOMPARE(counter, 1);
+		QVERIFY(observer.expired());
+		QVERIFY(observer.lock() == nullptr);
+		ObserverPtr<DTorMock> copy = observer;
+		observer = nullptr;
+		QVERIFY(copy.expired());
+	}
+
+	void test_derived() {
+		int counter = 0;
+		ObservableSharedPtr<DTorMockVirt> shrPtr{{}, &counter};
+		ObserverPtr<DTorMockVirtBase> observer{shrPtr};
+		ObservableSharedPtr<DTorMockVirtBase> locked = observer.lock();
+		QCOMPARE(locked.as<DTorMockVirt>()->cntr, &counter);
+		shrPtr = nullptr;
+		QVERIFY(not observer.expired());
+		locked = nullptr;
+		QVERIFY(observer.expired());
+		QCOMPARE(counter, 1);
+	}
+
+	void test_compact() {
+		int counter = 0;
+		CompactSharedPtr<DTorMock, ObservableCounting<>> shrPtr{{}, &counter};
+		ObserverPtr<DTorMock> observer{shrPtr};
+		QCOMPARE(observer.lock()->cntr, &counter);
+		shrPtr = nullptr;
+		QCOMPARE(counter, 1);
+		QVERIFY(observer.expired());
+	}
+
+	void test_pmr() {
+		CountingResource resource;
+		int counter = 0;
+		{
+			ObserverPtr<DTorMock> observer{nullptr};
+			{
+				ObservableSharedPtr<DTorMock> shrPtr{&resource, {}, &counter};
+				observer = shrPtr;
+			}
+			QCOMPARE(counter, 1);
+			QCOMPARE(resource.deallocations, 0);
+		}
+		QCOMPARE(resource.deallocations, 1);
+		QCOMPARE(resource.bytesInUse, 0u);
+	}
+
+	void test_threads() {
+		constexpr int THREAD_CNT = 8;
+		int counter = 0;
+		for (int round = 0; round < 100; ++round) {
+			ConcurrentObserverPtr<DTorMock> observer{nullptr};
+			std::vector<ConcurrentObservableSharedPtr<DTorMock>> owners;
+			{
+				ConcurrentObservableSharedPtr<DTorMock> shrPtr{{}, &counter};
+				observer = shrPtr;
+				owners.resize(THREAD_CNT, shrPtr);
+			}
+			std::vector<std::thread> threads;
+			for (int t = 0; t < THREAD_CNT; ++t) {
+				threads.emplace_back([observer, owner = std::move(owners[t])]() mutable {
+					owner = nullptr;
+					for (int i = 0; i < 100; ++i) {
+						if (auto locked = observer.lock()) {
+							(void)*locked->cntr;
+						}
+					}
+				});
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			QVERIFY(observer.expired());
+		}
+		QCOMPARE(counter, 100);
+	}
+
+};
+CAT_DECLARE_TEST(ObserverPtrTest);
+
+
 
 #include "sharedPtrTest.moc"
 
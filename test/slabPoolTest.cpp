@@ -0,0 +1,182 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_slabPool.h"
+#include "cat_sharedPtr.h"
+
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace cat;
+
+namespace {
+
+struct PooledMock {
+	int* cntr;
+
+	PooledMock(int* cntr): cntr(cntr) {}
+	virtual ~PooledMock() { (*cntr)++; }
+};
+CAT_POOLED_ALLOCATION(PooledMock)
+
+struct PooledMockDerived: PooledMock {
+	using PooledMock::PooledMock;
+};
+
+struct alignas(64) PooledOverAligned {
+	int value;
+};
+CAT_POOLED_ALLOCATION(PooledOverAligned)
+
+bool isAligned(void* ptr, size_t alignment) {
+	return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+}
+
+class SlabPoolTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	SlabPoolTest() {}
+	~SlabPoolTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_usePooledAllocation() {
+		QVERIFY(usePooledAllocation_v<PooledMock>);
+		QVERIFY(usePooledAllocation_v<const PooledMock>);
+		QVERIFY(usePooledAllocation_v<PooledMockDerived>);
+		QVERIFY(not usePooledAllocation_v<int>);
+	}
+
+	void test_allocate_1() {
+		using Pool = SlabPool<40, 8>;
+		std::set<void*> blocks;
+		for (int i = 0; i < 1000; ++i) {
+			void* block = Pool::allocate();
+			QVERIFY(isAligned(block, 8));
+			blocks.insert(block);
+		}
+		QCOMPARE(blocks.size(), 1000u);
+		for (void* block : blocks) {
+			Pool::deallocate(block);
+		}
+	}
+
+	void test_allocate_2() {
+		using Pool = SlabPool<24, 64>;
+		QCOMPARE(Pool::BLOCK_SIZE, 64u);
+		for (int i = 0; i < 100; ++i) {
+			void* block = Pool::allocate();
+			QVERIFY(isAligned(block, 64));
+			Pool::deallocate(block);
+		}
+	}
+
+	void test_deallocate() {
+		using Pool = SlabPool<40, 8>;
+		void* block1 = Pool::allocate();
+		Pool::deallocate(block1);
+		void* block2 = Pool::allocate();
+		QCOMPARE(block2, block1);
+		Pool::deallocate(block2);
+	}
+
+	void test_threads() {
+		using Pool = SlabPool<sizeof(int) * 8, alignof(int)>;
+		constexpr int THREAD_CNT = 8;
+		constexpr int BLOCK_CNT = 2000;
+
+		std::vector<std::vector<int*>> handOver(THREAD_CNT);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREAD_CNT; ++t) {
+			threads.emplace_back([&handOver, t]() {
+				for (int round = 0; round < 10; ++round) {
+					std::vector<int*> blocks;
+					for (int i = 0; i < BLOCK_CNT; ++i) {
+						int* block = static_cast<int*>(Pool::allocate());
+						std::fill(block, block + 8, t * BLOCK_CNT + i);
+						blocks.push_back(block);
+					}
+					for (int i = 0; i < BLOCK_CNT; ++i) {
+						if (blocks[i][0] != t * BLOCK_CNT + i || blocks[i][7] != t * BLOCK_CNT + i) {
+							return; // handOver stays empty -> test fails.
+						}
+					}
+					for (int i = 0; i < BLOCK_CNT / 2; ++i) {
+						Pool::deallocate(blocks[i]);
+					}
+					blocks.erase(blocks.begin(), blocks.begin() + BLOCK_CNT / 2);
+					if (round == 9) {
+						handOver[t] = std::move(blocks); // deallocated by another thread.
+					} else {
+						for (int* block : blocks) {
+							Pool::deallocate(block);
+						}
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		for (auto& blocks : handOver) {
+			QCOMPARE(blocks.size(), size_t(BLOCK_CNT / 2));
+			for (int* block : blocks) {
+				Pool::deallocate(block);
+			}
+		}
+	}
+
+	void test_sharedPtr_1() {
+		using RefCnt = _sharedPtr_internal::SharedPtrRefCntInplace_<PooledMock>;
+		using Pool = SlabPool<sizeof(RefCnt), alignof(RefCnt)>;
+		int counter = 0;
+		char* block = static_cast<char*>(Pool::allocate());
+		Pool::deallocate(block);
+
+		SharedPtr<PooledMock> shrPtr{{}, &counter};
+		char* payload = reinterpret_cast<char*>(shrPtr.___getPtr());
+		QVERIFY(payload > block && payload < block + sizeof(RefCnt));
+		shrPtr = nullptr;
+		QCOMPARE(counter, 1);
+		void* reused = Pool::allocate();
+		QCOMPARE(reused, static_cast<void*>(block));
+		Pool::deallocate(reused);
+	}
+
+	void test_sharedPtr_2() {
+		int counter = 0;
+		{
+			std::vector<CompactSharedPtr<PooledMockDerived, AtomicCounting>> ptrs;
+			for (int i = 0; i < 1000; ++i) {
+				ptrs.emplace_back(InplaceConstructorTag{}, &counter);
+			}
+			std::thread other([ptrs = std::move(ptrs)]() mutable {
+				ptrs.clear();
+			});
+			other.join();
+		}
+		QCOMPARE(counter, 1000);
+	}
+
+	void test_sharedPtr_3() {
+		SharedPtr<PooledOverAligned> shrPtr{{}, 7};
+		QVERIFY(isAligned(shrPtr.___getPtr(), 64));
+		QCOMPARE(shrPtr->value, 7);
+	}
+
+};
+CAT_DECLARE_TEST(SlabPoolTest);
+
+
+
+#include "slabPoolTest.moc"
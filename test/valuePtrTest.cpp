@@ -0,0 +1,192 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "catPointers.h"
+
+#include <string>
+#include <vector>
+
+using namespace cat;
+
+namespace {
+
+struct Shape {
+	static inline int liveCnt = 0;
+
+	int id;
+	Shape(int id = 0): id(id) { liveCnt++; }
+	Shape(const Shape& other) noexcept: id(other.id) { liveCnt++; }
+	virtual ~Shape() { liveCnt--; }
+	virtual double area() const { return 0; }
+};
+
+struct Square: Shape {
+	double side;
+	Square(int id, double side): Shape(id), side(side) {}
+	double area() const override { return side * side; }
+};
+
+struct BigPolygon: Shape {
+	double points[32] = {};
+	BigPolygon(int id): Shape(id) { points[31] = 1; }
+	double area() const override { return points[31]; }
+};
+
+struct Other {
+	int x = 7;
+};
+
+/**
+ * Not polymorphic and the base is not at offset 0.
+ */
+struct Labeled: Other, Shape {
+	std::string label;
+	Labeled(std::string label): Shape(3), label(std::move(label)) {}
+};
+
+PTRS_FOR_STRUCT(Node)
+struct Node {
+	int value = 0;
+};
+
+}
+
+class ValuePtrTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	ValuePtrTest() {}
+	~ValuePtrTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_ctor() {
+		ValuePtr<Shape> null;
+		QVERIFY(null == nullptr);
+		QVERIFY(not null);
+
+		ValuePtr<Shape> shape{{}, 5};
+		QVERIFY(shape != nullptr);
+		QCOMPARE(shape->id, 5);
+		QVERIFY(shape.isInline());
+	}
+
+	void test_make_inline() {
+		Shape::liveCnt = 0;
+		{
+			auto square = ValuePtr<Shape>::make<Square>(1, 3.0);
+			QVERIFY(square.isInline());
+			QCOMPARE(square->area(), 9.0);
+			QCOMPARE(square.as<Square>()->side, 3.0);
+			QVERIFY(square.as<BigPolygon>() == nullptr);
+			QCOMPARE(square.asStatic<Square>()->side, 3.0);
+			QCOMPARE(Shape::liveCnt, 1);
+		}
+		QCOMPARE(Shape::liveCnt, 0);
+	}
+
+	void test_make_heap() {
+		Shape::liveCnt = 0;
+		{
+			QVERIFY(not ValuePtr<Shape>::isInline_v<BigPolygon>);
+			auto polygon = ValuePtr<Shape>::make<BigPolygon>(2);
+			QVERIFY(not polygon.isInline());
+			QCOMPARE(polygon->area(), 1.0);
+
+			ValuePtr<Shape, sizeof(BigPolygon)> inlinePolygon = ValuePtr<Shape, sizeof(BigPolygon)>::make<BigPolygon>(2);
+			QVERIFY(inlinePolygon.isInline());
+		}
+		QCOMPARE(Shape::liveCnt, 0);
+	}
+
+	void test_copy() {
+		Shape::liveCnt = 0;
+		{
+			auto square = ValuePtr<Shape>::make<Square>(1, 2.0);
+			ValuePtr<Shape> copy = square;
+			QVERIFY(copy != square); // a different object...
+			QCOMPARE(copy->area(), 4.0); // ...of the same type.
+			QVERIFY(copy.as<Square>() != nullptr);
+
+			auto polygon = ValuePtr<Shape>::make<BigPolygon>(2);
+			ValuePtr<Shape> polygonCopy = polygon;
+			QVERIFY(not polygonCopy.isInline());
+			QCOMPARE(polygonCopy->area(), 1.0);
+
+			copy = polygon;
+			QVERIFY(copy.as<BigPolygon>() != nullptr);
+			copy = copy;
+			QVERIFY(copy.as<BigPolygon>() != nullptr);
+			QCOMPARE(Shape::liveCnt, 4);
+		}
+		QCOMPARE(Shape::liveCnt, 0);
+	}
+
+	void test_move() {
+		Shape::liveCnt = 0;
+		{
+			auto square = ValuePtr<Shape>::make<Square>(1, 2.0);
+			ValuePtr<Shape> moved = std::move(square);
+			QVERIFY(square == nullptr);
+			QVERIFY(moved.isInline());
+			QCOMPARE(moved->area(), 4.0);
+
+			auto polygon = ValuePtr<Shape>::make<BigPolygon>(2);
+			Shape* target = polygon.___getPtr();
+			ValuePtr<Shape> movedPolygon = std::move(polygon);
+			QCOMPARE(movedPolygon.___getPtr(), target); // heap objects are handed over.
+
+			moved = std::move(movedPolygon);
+			QCOMPARE(moved.___getPtr(), target);
+			QCOMPARE(Shape::liveCnt, 1);
+
+			std::vector<ValuePtr<Shape>> shapes;
+			for (int i = 0; i < 100; ++i) {
+				shapes.push_back(ValuePtr<Shape>::make<Square>(i, double(i)));
+			}
+			QCOMPARE(shapes[99]->area(), 99.0 * 99.0);
+			QCOMPARE(Shape::liveCnt, 101);
+		}
+		QCOMPARE(Shape::liveCnt, 0);
+	}
+
+	void test_baseOffset() {
+		Shape::liveCnt = 0;
+		{
+			auto labeled = ValuePtr<Shape>::make<Labeled>("label");
+			QVERIFY(labeled.isInline() == ValuePtr<Shape>::isInline_v<Labeled>);
+			QCOMPARE(labeled->id, 3);
+			ValuePtr<Shape> copy = labeled;
+			ValuePtr<Shape> moved = std::move(labeled);
+			QCOMPARE(moved.as<Labeled>()->label, std::string("label"));
+			QCOMPARE(copy.as<Labeled>()->x, 7);
+		}
+		QCOMPARE(Shape::liveCnt, 0);
+	}
+
+	void test_const() {
+		ValuePtr<const Shape> shape = ValuePtr<const Shape>::make<Square>(1, 2.0);
+		QCOMPARE(shape->area(), 4.0);
+		ValuePtr<const Shape> copy = shape;
+		QCOMPARE(copy->area(), 4.0);
+	}
+
+	void test_aliases() {
+		NodeValuePtr node{InplaceConstructorTag{}};
+		node->value = 3;
+		NodeCValuePtr constNode{InplaceConstructorTag{}};
+		QCOMPARE(node->value, 3);
+		QCOMPARE(constNode->value, 0);
+	}
+
+};
+CAT_DECLARE_TEST(ValuePtrTest);
+
+
+
+#include "valuePtrTest.moc"
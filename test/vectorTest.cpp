@@ -0,0 +1,255 @@
+#include <QtTest>
+
+#include "autoTest.h"
+
+// add necessary includes here
+#include "cat_vector.h"
+#include "catPointers.h"
+#include "cat_cowPtr.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace cat;
+
+namespace {
+
+struct Node {
+	static inline int liveCnt = 0;
+
+	int value;
+	Node(int value): value(value) { liveCnt++; }
+	~Node() { liveCnt--; }
+};
+
+/**
+ * Refers to its own address, so it must not be relocated with memcpy().
+ */
+struct SelfRef {
+	static inline int liveCnt = 0;
+
+	SelfRef* self;
+	int value;
+	SelfRef(int value = 0): self(this), value(value) { liveCnt++; }
+	SelfRef(const SelfRef& other): self(this), value(other.value) { liveCnt++; }
+	SelfRef& operator =(const SelfRef& other) { value = other.value; return *this; }
+	~SelfRef() { liveCnt--; }
+};
+
+/**
+ * Move-only, and its move constructor throws once movesLeft runs out.
+ */
+struct ThrowingMove {
+	static inline int liveCnt = 0;
+	static inline int movesLeft = -1;
+
+	int value;
+	ThrowingMove(int value): value(value) { liveCnt++; }
+	ThrowingMove(ThrowingMove&& other): value(other.value) {
+		if (movesLeft-- == 0) {
+			throw std::runtime_error("move");
+		}
+		liveCnt++;
+	}
+	~ThrowingMove() { liveCnt--; }
+};
+
+static_assert(isTriviallyRelocatable_v<int>);
+static_assert(isTriviallyRelocatable_v<WeakPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<OwningPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<PmrOwningPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<PromotableOwningPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<SharedPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<const ConcurrentSharedPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<CompactSharedPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<ObserverPtr<Node>>);
+static_assert(isTriviallyRelocatable_v<CowPtr<Node>>);
+static_assert(not isTriviallyRelocatable_v<ValuePtr<Node>>);
+static_assert(not isTriviallyRelocatable_v<SelfRef>);
+
+template <class Vector_>
+std::vector<int> valuesOf(const Vector_& vector) {
+	std::vector<int> result;
+	for (const auto& element : vector) {
+		result.push_back(element->value);
+	}
+	return result;
+}
+
+std::vector<int> valuesOf(const Vector<SelfRef>& vector) {
+	std::vector<int> result;
+	for (const auto& element : vector) {
+		result.push_back(element.value);
+		if (element.self != &element) {
+			result.push_back(-1);
+		}
+	}
+	return result;
+}
+
+}
+
+class VectorTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	VectorTest() {}
+	~VectorTest() {}
+
+private slots:
+	void initTestCase() {}
+	void cleanupTestCase() {}
+
+	void test_growth() {
+		Node::liveCnt = 0;
+		{
+			Vector<OwningPtr<Node>> nodes;
+			QVERIFY(nodes.empty());
+			for (int i = 0; i < 100; ++i) {
+				nodes.push_back(OwningPtr<Node>({}, i));
+			}
+			QCOMPARE(nodes.size(), 100u);
+			QVERIFY(nodes.capacity() >= 100u);
+			QCOMPARE(nodes[57]->value, 57);
+			QCOMPARE(nodes.back()->value, 99);
+			QCOMPARE(Node::liveCnt, 100);
+
+			nodes.pop_back();
+			QCOMPARE(Node::liveCnt, 99);
+			nodes.resize(10);
+			QCOMPARE(Node::liveCnt, 10);
+			nodes.resize(12);
+			QCOMPARE(nodes[11], nullptr);
+		}
+		QCOMPARE(Node::liveCnt, 0);
+	}
+
+	void test_insert() {
+		Node::liveCnt = 0;
+		{
+			Vector<OwningPtr<Node>> nodes;
+			nodes.insert(nodes.begin(), OwningPtr<Node>({}, 2));
+			nodes.insert(nodes.begin(), OwningPtr<Node>({}, 0));
+			nodes.insert(nodes.begin() + 1, OwningPtr<Node>({}, 1));
+			nodes.insert(nodes.end(), OwningPtr<Node>({}, 3));
+			nodes.insert(nodes.begin() + 2, OwningPtr<Node>({}, 9));
+			QCOMPARE(valuesOf(nodes), (std::vector<int>{0, 1, 9, 2, 3}));
+			QCOMPARE(Node::liveCnt, 5);
+		}
+		QCOMPARE(Node::liveCnt, 0);
+	}
+
+	void test_insert_aliasing() {
+		Vector<SharedPtr<Node>> nodes;
+		nodes.push_back(SharedPtr<Node>({}, 0));
+		for (int i = 1; i < 20; ++i) {
+			nodes.insert(nodes.begin(), nodes.back()); // may reallocate.
+			nodes.emplace_back(nodes.front());
+		}
+		QCOMPARE(nodes.size(), 39u);
+		for (const auto& node : nodes) {
+			QCOMPARE(node, nodes[0]);
+		}
+	}
+
+	void test_erase() {
+		Node::liveCnt = 0;
+		{
+			Vector<OwningPtr<Node>> nodes;
+			for (int i = 0; i < 6; ++i) {
+				nodes.emplace_back(OwningPtr<Node>({}, i));
+			}
+			auto it = nodes.erase(nodes.begin() + 1);
+			QCOMPARE((*it)->value, 2);
+			QCOMPARE(Node::liveCnt, 5);
+			it = nodes.erase(nodes.begin() + 2, nodes.begin() + 4);
+			QCOMPARE((*it)->value, 5);
+			QCOMPARE(valuesOf(nodes), (std::vector<int>{0, 2, 5}));
+			QCOMPARE(Node::liveCnt, 3);
+			nodes.erase(nodes.end() - 1);
+			QCOMPARE(valuesOf(nodes), (std::vector<int>{0, 2}));
+			nodes.clear();
+			QCOMPARE(Node::liveCnt, 0);
+		}
+		QCOMPARE(Node::liveCnt, 0);
+	}
+
+	void test_shared() {
+		Node::liveCnt = 0;
+		{
+			SharedPtr<Node> node{{}, 7};
+			Vector<SharedPtr<Node>> nodes;
+			for (int i = 0; i < 50; ++i) {
+				nodes.push_back(node);
+			}
+			nodes.erase(nodes.begin() + 10, nodes.begin() + 20);
+			Vector<SharedPtr<Node>> copy = nodes;
+			Vector<SharedPtr<Node>> moved = std::move(nodes);
+			QVERIFY(nodes.empty());
+			QCOMPARE(copy.size(), 40u);
+			QCOMPARE(moved.size(), 40u);
+			copy = moved;
+			QCOMPARE(copy[39], node);
+			QCOMPARE(Node::liveCnt, 1);
+		}
+		QCOMPARE(Node::liveCnt, 0);
+	}
+
+	void test_not_relocatable() {
+		SelfRef::liveCnt = 0;
+		{
+			Vector<SelfRef> values;
+			for (int i = 0; i < 10; ++i) {
+				values.emplace_back(i);
+			}
+			values.insert(values.begin() + 3, SelfRef(42));
+			values.erase(values.begin(), values.begin() + 2);
+			values.erase(values.begin() + 5);
+			QCOMPARE(valuesOf(values), (std::vector<int>{2, 42, 3, 4, 5, 7, 8, 9}));
+			Vector<SelfRef> copy = values;
+			QCOMPARE(valuesOf(copy), valuesOf(values));
+			QCOMPARE(SelfRef::liveCnt, 16);
+		}
+		QCOMPARE(SelfRef::liveCnt, 0);
+	}
+
+	void test_throwingMove() {
+		ThrowingMove::liveCnt = 0;
+		{
+			Vector<ThrowingMove> values;
+			for (int i = 0; i < 4; ++i) {
+				values.emplace_back(i);
+			}
+			ThrowingMove::movesLeft = 2; // throws while growing, after two elements were moved.
+			bool threw = false;
+			try {
+				values.emplace_back(4);
+			} catch (const std::runtime_error&) {
+				threw = true;
+			}
+			ThrowingMove::movesLeft = -1;
+			QVERIFY(threw);
+			QCOMPARE(values.size(), size_t(4));
+			QCOMPARE(ThrowingMove::liveCnt, 4); // the moved and the new elements were destroyed again.
+		}
+		QCOMPARE(ThrowingMove::liveCnt, 0);
+	}
+
+	void test_strings() {
+		Vector<std::string> strings;
+		for (int i = 0; i < 20; ++i) {
+			strings.insert(strings.begin(), std::to_string(i) + " is a string that is too long for the small buffer");
+		}
+		strings.erase(strings.begin() + 1, strings.end() - 1);
+		QCOMPARE(strings.size(), 2u);
+		QCOMPARE(strings[0].substr(0, 2), std::string("19"));
+		QCOMPARE(strings[1].substr(0, 2), std::string("0 "));
+	}
+
+};
+CAT_DECLARE_TEST(VectorTest);
+
+
+
+#include "vectorTest.moc"
@@ -67,7 +67,7 @@ private slots:
         int val = 0;
         WeakPtr<int> ptr1{&val};
         WeakPtr<int> ptr2{std::move(ptr1)};
-        QCOMPARE(ptr1.___getPtr(), nullptr);
+        QCOMPARE(ptr1.___getPtr(), &val); // moving is a trivial copy.
         QCOMPARE(ptr2.___getPtr(), &val);
     }
 
@@ -85,7 +85,7 @@ private slots:
         WeakPtr<int> ptr1{&val};
         WeakPtr<int> ptr2;
         ptr2 = std::move(ptr1);
-        QCOMPARE(ptr1.___getPtr(), nullptr);
+        QCOMPARE(ptr1.___getPtr(), &val);
         QCOMPARE(ptr2.___getPtr(), &val);
     }
 
@@ -94,7 +94,7 @@ private slots:
         WeakPtr<Point2> ptr1{&val};
         WeakPtr<IGeometry> ptr2;
         ptr2 = std::move(ptr1);
-        QCOMPARE(ptr1.___getPtr(), nullptr);
+        QCOMPARE(ptr1.___getPtr(), &val);
         QCOMPARE(ptr2.___getPtr(), &val);
         QCOMPARE(ptr2->id, val.id);
     }